@@ -147,8 +147,8 @@ void PrintBanner() {
   std::cout << "Sergey Kosarevsky, 2014-2023" << std::endl;
   std::cout << "support@linderdaum.com http://www.linderdaum.com http://blog.linderdaum.com" << std::endl;
   std::cout << std::endl;
-  std::cout << "Usage: Poisson [density-map-rgb24.bmp] [--raw-points] [--num-points=<value>] [--square] [--vogel-disk | --jittered-grid | "
-               "--hammersley]"
+  std::cout << "Usage: Poisson [density-map-rgb24.bmp] [--raw-points] [--binary] [--num-points=<value>] [--square] [--vogel-disk | "
+               "--jittered-grid | --hammersley]"
             << std::endl;
   std::cout << std::endl;
 }
@@ -163,6 +163,7 @@ int main(int argc, char** argv) {
   }
 
   const bool cmdRawPointsOutput = cmdl[{"--raw-points"}];
+  const bool cmdBinaryOutput = cmdl[{"--binary"}];
   const bool cmdSquare = cmdl[{"--square"}];
   const bool cmdVogelDisk = cmdl[{"--vogel-disk"}];
   const bool cmdJitteredGrid = cmdl[{"--jittered-grid"}];
@@ -178,10 +179,19 @@ int main(int argc, char** argv) {
 
   PoissonGenerator::DefaultPRNG PRNG;
 
+  // the Poisson generator consumes the density map directly and produces only the points we keep
+  PoissonGenerator::DensityMap densityMap;
+  densityMap.data = g_DensityMap;
+  densityMap.w = kImageSize;
+  densityMap.h = kImageSize;
+
   const auto Points = cmdVogelDisk      ? PoissonGenerator::generateVogelPoints(numPoints)
                       : cmdJitteredGrid ? PoissonGenerator::generateJitteredGridPoints(numPoints, PRNG, !cmdSquare)
                       : cmdHammersley   ? PoissonGenerator::generateHammersleyPoints(numPoints)
-                                        : PoissonGenerator::generatePoissonPoints(numPoints, PRNG, !cmdSquare);
+                                        : PoissonGenerator::generatePoissonPoints(numPoints, PRNG, !cmdSquare, 30, -1.0f, densityMap);
+
+  // the other generators know nothing about density - thin their output by dicing as before
+  const bool diceAgainstDensityMap = g_DensityMap && (cmdVogelDisk || cmdJitteredGrid || cmdHammersley);
 
   // prepare BGR image
   const size_t DataSize = 3 * kImageSize * kImageSize;
@@ -195,7 +205,7 @@ int main(int argc, char** argv) {
     int y = int(i->y * kImageSize);
     if (x < 0 || y < 0 || x >= kImageSize || y >= kImageSize)
       continue;
-    if (g_DensityMap) {
+    if (diceAgainstDensityMap) {
       // dice
       float R = PRNG.randomFloat();
       float P = g_DensityMap[x + y * kImageSize];
@@ -210,6 +220,16 @@ int main(int argc, char** argv) {
 
   delete[] (Img);
 
+  if (cmdBinaryOutput) {
+    // packed binary dump - orders of magnitude faster than the text formats for large point sets
+    if (PoissonGenerator::savePointsBinary("points.bin", Points))
+      std::cout << "Saved points.bin" << std::endl;
+    else
+      std::cout << "ERROR: cannot save points.bin" << std::endl;
+
+    return 0;
+  }
+
   // dump points to a text file
   std::ofstream File("points.txt", std::ios::out);
 
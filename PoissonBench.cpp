@@ -0,0 +1,188 @@
+/**
+ * \file PoissonBench.cpp
+ * \brief
+ *
+ * Poisson Disk Points Generator benchmark
+ *
+ * \version 1.10.2
+ * \date 29/08/2026
+ * \author Sergey Kosarevsky, 2014-2024
+ * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
+ */
+
+/*
+   Measures points/sec, peak RSS, candidate-rejection rate and p50/p99 per-batch latency
+   for all generators over a range of point counts, as CSV for dashboard tracking.
+
+   Usage: PoissonBench [--min-points=<value>] [--max-points=<value>] [--square] [--num-threads=<value>] [--csv=<file>]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "PoissonGenerator.h"
+
+#include "argh/argh.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+const uint32_t kBatchSize = 65536; // points per latency batch
+
+size_t getPeakRSSKb() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS info;
+  GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info));
+  return size_t(info.PeakWorkingSetSize / 1024);
+#else
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return size_t(usage.ru_maxrss);
+#endif
+}
+
+struct BenchResult {
+  std::string generator;
+  std::string shape;
+  uint32_t requestedPoints = 0;
+  size_t generatedPoints = 0;
+  double elapsedMs = 0.0;
+  double pointsPerSec = 0.0;
+  double p50BatchMs = 0.0;
+  double p99BatchMs = 0.0;
+  double rejectionRate = 0.0; // Poisson only; 0 for the closed-form generators
+  size_t peakRSSKb = 0;
+};
+
+double percentile(std::vector<double> values, double p) {
+  if (values.empty())
+    return 0.0;
+  std::sort(values.begin(), values.end());
+  size_t idx = size_t(p * double(values.size() - 1) + 0.5);
+  if (idx > values.size() - 1)
+    idx = values.size() - 1;
+  return values[idx];
+}
+
+double toMs(std::chrono::steady_clock::duration d) {
+  return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(d).count();
+}
+
+BenchResult benchPoisson(uint32_t numPoints, bool isCircle) {
+  BenchResult r;
+  r.generator = "poisson";
+
+  PoissonGenerator::DefaultPRNG prng;
+  PoissonGenerator::PoissonSampler<PoissonGenerator::DefaultPRNG> sampler(numPoints, prng, isCircle);
+
+  std::vector<double> batchMs;
+
+  const auto start = std::chrono::steady_clock::now();
+  while (!sampler.isDone()) {
+    const auto batchStart = std::chrono::steady_clock::now();
+    sampler.step(kBatchSize);
+    batchMs.push_back(toMs(std::chrono::steady_clock::now() - batchStart));
+  }
+  r.elapsedMs = toMs(std::chrono::steady_clock::now() - start);
+
+  r.generatedPoints = sampler.points().size();
+  r.p50BatchMs = percentile(batchMs, 0.50);
+  r.p99BatchMs = percentile(batchMs, 0.99);
+  if (sampler.numCandidatesTried())
+    r.rejectionRate = 1.0 - double(r.generatedPoints) / double(sampler.numCandidatesTried());
+  return r;
+}
+
+BenchResult benchPoissonParallel(uint32_t numPoints, bool isCircle, uint32_t numThreads) {
+  BenchResult r;
+  r.generator = "poisson-parallel";
+
+  PoissonGenerator::DefaultPRNG prng;
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto points = PoissonGenerator::generatePoissonPointsParallel(numPoints, prng, numThreads, isCircle);
+  r.elapsedMs = toMs(std::chrono::steady_clock::now() - start);
+
+  r.generatedPoints = points.size();
+  r.p50BatchMs = r.p99BatchMs = r.elapsedMs;
+  return r;
+}
+
+template<typename GENFUNC>
+BenchResult benchClosedForm(const char* name, GENFUNC generate) {
+  BenchResult r;
+  r.generator = name;
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto points = generate();
+  r.elapsedMs = toMs(std::chrono::steady_clock::now() - start);
+
+  r.generatedPoints = points.size();
+  r.p50BatchMs = r.p99BatchMs = r.elapsedMs;
+  return r;
+}
+
+void printResult(std::ostream& out, const BenchResult& r) {
+  out << r.generator << "," << r.shape << "," << r.requestedPoints << "," << r.generatedPoints << "," << r.elapsedMs << ","
+      << r.pointsPerSec << "," << r.p50BatchMs << "," << r.p99BatchMs << "," << r.rejectionRate << "," << r.peakRSSKb << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  (void)argc;
+
+  argh::parser cmdl(argv);
+
+  unsigned int minPoints, maxPoints, numThreads;
+  cmdl("min-points", 10000) >> minPoints;
+  cmdl("max-points", 1000000) >> maxPoints;
+  cmdl("num-threads", std::thread::hardware_concurrency()) >> numThreads;
+  const bool isCircle = !cmdl[{"--square"}];
+
+  std::string csvFileName;
+  cmdl("csv", "") >> csvFileName;
+
+  std::ofstream csvFile;
+  if (!csvFileName.empty())
+    csvFile.open(csvFileName, std::ios::out);
+  std::ostream& out = csvFile.is_open() ? csvFile : std::cout;
+
+  std::cerr << "Poisson disk points generator benchmark, version " << PoissonGenerator::Version << std::endl;
+
+  out << "generator,shape,requested_points,generated_points,elapsed_ms,points_per_sec,p50_batch_ms,p99_batch_ms,rejection_rate,peak_rss_kb"
+      << std::endl;
+
+  for (uint32_t numPoints = minPoints; numPoints <= maxPoints; numPoints *= 10) {
+    PoissonGenerator::DefaultPRNG prng;
+
+    BenchResult results[] = {
+        benchPoisson(numPoints, isCircle),
+        benchPoissonParallel(numPoints, isCircle, numThreads),
+        benchClosedForm("vogel", [numPoints]() { return PoissonGenerator::generateVogelPoints(numPoints); }),
+        benchClosedForm("jittered-grid", [numPoints, &prng]() mutable { return PoissonGenerator::generateJitteredGridPoints(numPoints, prng); }),
+        benchClosedForm("hammersley", [numPoints]() { return PoissonGenerator::generateHammersleyPoints(numPoints); }),
+    };
+
+    for (BenchResult& r : results) {
+      r.shape = isCircle ? "circle" : "square";
+      r.requestedPoints = numPoints;
+      r.pointsPerSec = r.elapsedMs > 0.0 ? 1000.0 * double(r.generatedPoints) / r.elapsedMs : 0.0;
+      r.peakRSSKb = getPeakRSSKb();
+      printResult(out, r);
+    }
+  }
+
+  return 0;
+}
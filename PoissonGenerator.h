@@ -4,8 +4,8 @@
  *
  * Poisson Disk Points Generator
  *
- * \version 1.6.1
- * \date 16/02/2024
+ * \version 1.30.6
+ * \date 29/08/2026
  * \author Sergey Kosarevsky, 2014-2024
  * \author support@linderdaum.com   http://www.linderdaum.com   http://blog.linderdaum.com
  */
@@ -28,6 +28,43 @@
 // Implementation based on http://devmag.org.za/2009/05/03/poisson-disk-sampling/
 
 /* Versions history:
+ *		1.30.6  Aug 29, 2026    Bugfix: wrapUnit() keeps the result strictly below 1 - tiny negative inputs rounded to 1.0f and wrote one cell past the toroidal grid
+ *		1.30.5  Aug 29, 2026    Bugfix: generatePoissonPointsTileable() snaps the grid to a whole number of cells - the partial last row/column let points violate minDist across the seam
+ *		1.30.4  Aug 29, 2026    Bugfix: replayPoissonPoints() floors the thread count at 2 - tokens replay bit-identically on single-core machines
+ *		1.30.3  Aug 29, 2026    Multi-class: (r_a+r_b)/2 default threshold, non-positive matrix entries refused
+ *		1.30.2  Aug 29, 2026    Bugfix: zero-capacity buffer outputs return 0 instead of looping forever
+ *		1.30.1  Aug 29, 2026    Bugfix: bounded first-point search - an all-zero density map no longer hangs the sampler
+ *		1.30    Aug 29, 2026    Added estimatePoissonPointCapacity() packing-density sizing and an optional strict maxPoints cap
+ *		1.29    Aug 29, 2026    Added PatternCache - mmap-backed pattern library keyed by ReplayToken, plus stampPattern() per-instance placement
+ *		1.28    Aug 29, 2026    Added generateJitteredGridPointsExact() - rejection-free jittered grid returning exactly numPoints
+ *		1.27    Aug 29, 2026    SSE2 bulk kernels for generateVogelPoints() and generateHammersleyPoints(); Vogel sincos switched to the fastSin polynomial
+ *		1.26    Aug 29, 2026    Added generatePoissonPointsChunked() and PoissonSampler::drainPoints() - streamed spans with bounded resident memory
+ *		1.25    Aug 29, 2026    Added relaxPoints() - parallel grid-accelerated repulsion relaxation, and generatePoissonPointsRelaxed()
+ *		1.24    Aug 29, 2026    Added PointQueryIndex - cell-bucketed radiusQuery()/kNearest() over generated point sets, and generatePoissonPointsIndexed()
+ *		1.23    Aug 29, 2026    Added generatePoissonPointsWindow() - sub-rectangle generation seeded with neighbouring-window boundary points
+ *		1.22    Aug 29, 2026    Added PoissonPointSet - persistent point set with insert/remove by id and local gap repair
+ *		1.21    Aug 29, 2026    Backend-dispatching entry point with a GPU offload ABI hook and automatic CPU fallback
+ *		1.20    Aug 29, 2026    Added generatePoissonPointsExact() - pilot-tuned minDist, early termination at the exact count
+ *		1.19    Aug 29, 2026    Added generatePoissonPointsTileable() - toroidal domain with wrap-aware grid queries
+ *		1.18    Aug 29, 2026    Added reorderProgressive() - blue-noise prefix ordering for any generator output
+ *		1.17    Aug 29, 2026    Runtime progress observers - SampleStats reported at a configurable cadence
+ *		1.16.1  Aug 29, 2026    Replay tokens - reproduce a parallel point set bit-exactly from seed + parameters + Version
+ *		1.16    Aug 29, 2026    Added generatePoissonPointsND<N>() - dimension-templated sampling with a cache-blocked N-D grid
+ *		1.15    Aug 29, 2026    Added generateMultiClassPoissonPoints() - N point classes with an inter-class distance matrix in one pass
+ *		1.14    Aug 29, 2026    Compile-time shape policies (CircleDomain/SquareDomain, custom domains) - branch-free candidate loops
+ *		1.13    Aug 29, 2026    Binary points file format - savePointsBinary() and mmap-backed PointsFileView loader
+ *		1.12.1  Aug 29, 2026    Batched candidate generation with a vectorizable polynomial sincos
+ *		1.12    Aug 29, 2026    Added CounterPRNG (counter-based, splittable, batchable); DefaultPRNG aliasing UB fixed
+ *		1.11    Aug 29, 2026    Direct-to-buffer and SoA output overloads for all generators
+ *		1.10.3  Aug 29, 2026    Tight radius-derived scan window (5x5 instead of 11x11) with center-out row order
+ *		1.10.2  Aug 29, 2026    Added PoissonBench benchmark target with CSV throughput/latency/memory reporting
+ *		1.10.1  Aug 29, 2026    Upfront capacity reservations on the generation hot path
+ *		1.10    Aug 29, 2026    Density maps moved into the library - variable-radius sampling via DensityMap
+ *		1.9     Aug 29, 2026    Added PoissonSampler - incremental/resumable sampling with snapshot/restore
+ *		1.8.1   Aug 29, 2026    SSE2 4-lane squared-distance neighbourhood kernel with scalar fallback
+ *		1.8     Aug 29, 2026    Added generatePoissonPointsParallel() - lock-free tile-based multithreaded sampling
+ *		1.7.1   Aug 29, 2026    O(1) swap-with-back removal in popRandom()
+ *		1.7     Aug 29, 2026    Flat single-allocation SoA background grid with an occupancy bitmask
  *		1.6.1   Feb 16, 2024    Reformatted using .clang-format
  *		1.6     May 29, 2023    Added generateHammersleyPoints() to generate Hammersley points
  *		1.5     Mar 26, 2022    Added generateJitteredGridPoints() to generate jittered grid points
@@ -46,12 +83,36 @@
  *		1.0     May  6, 2014
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <math.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#if !defined(_WIN32)
+// PointsFileView mmap()s the payload on POSIX; on Windows it falls back to buffered reads
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// define POISSON_DISABLE_SIMD to force the scalar neighbourhood kernel
+#if !defined(POISSON_DISABLE_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define POISSON_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+#endif // !POISSON_DISABLE_SIMD
+
 namespace PoissonGenerator {
 
-const char* Version = "1.6.1 (16/02/2024)";
+const char* Version = "1.30.6 (29/08/2026)";
 
 class DefaultPRNG {
  public:
@@ -59,9 +120,43 @@ class DefaultPRNG {
   explicit DefaultPRNG(unsigned int seed) : seed_(seed) {}
   inline float randomFloat() {
     seed_ *= 521167;
-    uint32_t a = (seed_ & 0x007fffff) | 0x40000000;
-    // remap to 0..1
-    return 0.5f * (*((float*)&a) - 2.0f);
+    const uint32_t a = (seed_ & 0x007fffff) | 0x40000000;
+    // remap to 0..1; type-pun via memcpy to avoid strict-aliasing UB (bit-identical results)
+    float f;
+    memcpy(&f, &a, sizeof(f));
+    return 0.5f * (f - 2.0f);
+  }
+  inline uint32_t randomInt(uint32_t maxInt) {
+    return uint32_t(randomFloat() * maxInt);
+  }
+  inline uint32_t getSeed() const {
+    return seed_;
+  }
+
+ private:
+  uint32_t seed_ = 7133167;
+};
+
+/**
+   Counter-based PRNG (squares-style): every value is a pure function of (seed, counter),
+   so there is no loop-carried dependency across draws - randomFloats() fills whole lanes
+   of candidates at once and auto-vectorizes, and split() derives cheap independent,
+   reproducible substreams for threads or tiles. Satisfies the same concept as DefaultPRNG.
+   Note: unlike DefaultPRNG its full state does not round-trip through getSeed(), so use
+   DefaultPRNG when PoissonSampler snapshots have to resume mid-sequence
+**/
+class CounterPRNG {
+ public:
+  CounterPRNG() = default;
+  explicit CounterPRNG(unsigned int seed) : seed_(seed) {}
+  inline float randomFloat() {
+    return toFloat(squares32(counter_++));
+  }
+  // fill 'out' with 'count' consecutive values of the stream in one call
+  inline void randomFloats(float* out, uint32_t count) {
+    for (uint32_t i = 0; i != count; i++)
+      out[i] = toFloat(squares32(counter_ + i));
+    counter_ += count;
   }
   inline uint32_t randomInt(uint32_t maxInt) {
     return uint32_t(randomFloat() * maxInt);
@@ -69,9 +164,34 @@ class DefaultPRNG {
   inline uint32_t getSeed() const {
     return seed_;
   }
+  // an independent stream: same seed and stream index always yield the same sequence
+  inline CounterPRNG split(uint32_t streamIndex) const {
+    return CounterPRNG(seed_ + streamIndex * 0x9E3779B9u);
+  }
+
+ private:
+  inline uint32_t squares32(uint64_t counter) const {
+    // B. Widynski, "Squares: A Fast Counter-Based RNG", arXiv:2004.06278
+    const uint64_t key = (0x5851f42d4c957f2dULL ^ (uint64_t(seed_) * 0x9E3779B97F4A7C15ULL)) | 1ULL;
+    uint64_t x = counter * key;
+    const uint64_t y = x;
+    const uint64_t z = y + key;
+    x = x * x + y;
+    x = (x >> 32) | (x << 32);
+    x = x * x + z;
+    x = (x >> 32) | (x << 32);
+    x = x * x + y;
+    x = (x >> 32) | (x << 32);
+    return uint32_t((x * x + z) >> 32);
+  }
+  static inline float toFloat(uint32_t v) {
+    // 24 mantissa-sized bits remapped to [0..1)
+    return float(v >> 8) * (1.0f / 16777216.0f);
+  }
 
  private:
   uint32_t seed_ = 7133167;
+  uint64_t counter_ = 0;
 };
 
 struct Point {
@@ -102,6 +222,23 @@ struct Point {
   }
 };
 
+/**
+   Compile-time shape policies: the candidate loops are templated over the domain, so
+   isInside() resolves statically, inlines and keeps the inner loop free of the
+   circle-vs-square branch. Any user type with a matching isInside() works as well
+**/
+struct CircleDomain {
+  inline bool isInside(const Point& p) const {
+    return p.isInCircle();
+  }
+};
+
+struct SquareDomain {
+  inline bool isInside(const Point& p) const {
+    return p.isInRectangle();
+  }
+};
+
 struct GridPoint {
   GridPoint() = delete;
   GridPoint(int X, int Y) : x(X), y(Y) {}
@@ -117,30 +254,123 @@ GridPoint imageToGrid(const Point& P, float cellSize) {
   return GridPoint((int)(P.x / cellSize), (int)(P.y / cellSize));
 }
 
+/**
+   A density map over the unit square: values in [0..1], where 1 samples at the base
+   minimal distance and lower values sample sparser; 0 generates no points at all.
+   The layout matches the raw luminance buffer the demo app loads from a BMP file
+**/
+struct DensityMap {
+  const float* data = nullptr;
+  int w = 0;
+  int h = 0;
+
+  float sample(const Point& p) const {
+    if (!data)
+      return 1.0f;
+    int x = (int)(p.x * w);
+    int y = (int)(p.y * h);
+    if (x < 0)
+      x = 0;
+    if (y < 0)
+      y = 0;
+    if (x > w - 1)
+      x = w - 1;
+    if (y > h - 1)
+      y = h - 1;
+    return data[x + y * w];
+  }
+};
+
 struct Grid {
+  // number of adjucent cells to look for neighbour points: a cell whose nearest edge is
+  // 'reach' or farther away can never hold a conflicting point, so ceil(reach / cellSize)
+  // cells per side is exact - with cellSize = minDist / sqrt(2) that is a 5x5 window
+  static int scanCells(float reach, float cellSize) {
+    return (int)ceil(reach / cellSize);
+  }
+
   Grid(int w, int h, float cellSize) : w_(w), h_(h), cellSize_(cellSize) {
-    grid_.resize(h_);
-    for (auto i = grid_.begin(); i != grid_.end(); i++) {
-      i->resize(w);
-    }
+    // flat row-major SoA storage: one allocation per coordinate plane plus an occupancy plane,
+    // so the neighbourhood scan walks contiguous floats instead of chasing per-row vectors;
+    // occupancy is one byte per cell - concurrent tile workers of generatePoissonPointsParallel()
+    // write disjoint cells, and bytes (unlike bits of a shared mask word) are distinct memory locations
+    const size_t numCells = size_t(w_) * size_t(h_);
+    cellX_.resize(numCells);
+    cellY_.resize(numCells);
+    cellR_.resize(numCells, 0.0f);
+    cellClass_.resize(numCells, 0);
+    occupied_.resize(numCells, 0);
+  }
+  // 'radius' is the per-point minimal distance for variable-radius (density map) sampling;
+  // leave it at 0 for uniform sampling, where the query distance alone decides rejection.
+  // 'classIndex' tags the point for multi-class queries (0 when there is a single class)
+  void insert(const Point& p, float radius = 0.0f, uint32_t classIndex = 0) {
+    const GridPoint g = imageToGrid(p, cellSize_);
+    const size_t idx = size_t(g.y) * size_t(w_) + size_t(g.x);
+    cellX_[idx] = p.x;
+    cellY_[idx] = p.y;
+    cellR_[idx] = radius;
+    cellClass_[idx] = uint8_t(classIndex);
+    occupied_[idx] = 1;
+    if (radius > maxRadius_)
+      maxRadius_ = radius;
   }
-  void insert(const Point& p) {
+  // vacate the cell the point occupies (incremental editing)
+  void remove(const Point& p) {
     const GridPoint g = imageToGrid(p, cellSize_);
-    grid_[g.x][g.y] = p;
+    occupied_[size_t(g.y) * size_t(w_) + size_t(g.x)] = 0;
   }
   bool isInNeighbourhood(const Point& point, float minDist, float cellSize) {
     const GridPoint g = imageToGrid(point, cellSize);
 
-    // number of adjucent cells to look for neighbour points
-    const int D = 5;
+    // the scan window has to reach the largest per-point radius inserted so far;
+    // two points conflict when they are closer than max(radius_a, radius_b)
+    const float reach = minDist > maxRadius_ ? minDist : maxRadius_;
+    const int D = scanCells(reach, cellSize);
+
+    // scan the neighbourhood of the point in the grid, one contiguous SoA row at a time,
+    // rows ordered center-out - most rejections come from the nearest ring
+    for (int dj = 0; dj <= D; dj++) {
+      for (int j = g.y - dj; j <= g.y + dj; j += dj ? 2 * dj : 1) {
+        if (j < 0 || j >= h_)
+          continue;
+
+        const int i0 = g.x - D > 0 ? g.x - D : 0;
+        const int i1 = g.x + D < w_ - 1 ? g.x + D : w_ - 1;
+
+        if (rowHasNeighbour(size_t(j) * size_t(w_), i0, i1, point.x, point.y, minDist))
+          return true;
+      }
+    }
 
-    // scan the neighbourhood of the point in the grid
-    for (int i = g.x - D; i <= g.x + D; i++) {
-      for (int j = g.y - D; j <= g.y + D; j++) {
-        if (i >= 0 && i < w_ && j >= 0 && j < h_) {
-          const Point P = grid_[i][j];
+    return false;
+  }
 
-          if (P.valid_ && getDistance(P, point) < minDist)
+  // toroidal variant: the scan window and the point-to-point distances wrap around the
+  // domain borders, so a point near one edge conflicts with points near the opposite
+  // edge; wrapped rows are not contiguous, so this query stays scalar
+  bool isInNeighbourhoodWrapped(const Point& point, float minDist, float cellSize) const {
+    const GridPoint g = imageToGrid(point, cellSize);
+    const int D = scanCells(minDist, cellSize);
+
+    const int spanX = 2 * D + 1 < w_ ? 2 * D + 1 : w_;
+    const int spanY = 2 * D + 1 < h_ ? 2 * D + 1 : h_;
+
+    for (int oj = 0; oj != spanY; oj++) {
+      const int j = ((g.y - D + oj) % h_ + h_) % h_;
+      const size_t row = size_t(j) * size_t(w_);
+
+      for (int oi = 0; oi != spanX; oi++) {
+        const int i = ((g.x - D + oi) % w_ + w_) % w_;
+        const size_t idx = row + size_t(i);
+
+        if (isOccupied(idx)) {
+          // shortest distance on the unit torus
+          float dx = cellX_[idx] - point.x;
+          float dy = cellY_[idx] - point.y;
+          dx -= floorf(dx + 0.5f);
+          dy -= floorf(dy + 0.5f);
+          if (dx * dx + dy * dy < minDist * minDist)
             return true;
         }
       }
@@ -149,18 +379,98 @@ struct Grid {
     return false;
   }
 
+  // multi-class variant: the distance threshold against each stored point is looked up by
+  // that point's class in 'thrByClass'; 'reach' is the largest entry of the row. The
+  // per-cell class lookup is a gather, so this query stays scalar - the window is tight
+  bool isInNeighbourhoodMultiClass(const Point& point, const float* thrByClass, float reach, float cellSize) const {
+    const GridPoint g = imageToGrid(point, cellSize);
+    const int D = scanCells(reach, cellSize);
+
+    for (int dj = 0; dj <= D; dj++) {
+      for (int j = g.y - dj; j <= g.y + dj; j += dj ? 2 * dj : 1) {
+        if (j < 0 || j >= h_)
+          continue;
+
+        const int i0 = g.x - D > 0 ? g.x - D : 0;
+        const int i1 = g.x + D < w_ - 1 ? g.x + D : w_ - 1;
+        const size_t row = size_t(j) * size_t(w_);
+
+        for (int i = i0; i <= i1; i++) {
+          const size_t idx = row + size_t(i);
+          if (isOccupied(idx)) {
+            const float dx = cellX_[idx] - point.x;
+            const float dy = cellY_[idx] - point.y;
+            const float thr = thrByClass[cellClass_[idx]];
+            if (dx * dx + dy * dy < thr * thr)
+              return true;
+          }
+        }
+      }
+    }
+
+    return false;
+  }
+
+ private:
+  bool isOccupied(size_t idx) const {
+    return occupied_[idx] != 0;
+  }
+  // test a [i0..i1] span of one grid row for an occupied cell closer than the pairwise
+  // minimal distance max(minDist, cellR); cellR is 0 everywhere for uniform sampling
+  bool rowHasNeighbour(size_t row, int i0, int i1, float px, float py, float minDist) const {
+    int i = i0;
+#if POISSON_SIMD_SSE2
+    const __m128 vpx = _mm_set1_ps(px);
+    const __m128 vpy = _mm_set1_ps(py);
+    const __m128 vminDist = _mm_set1_ps(minDist);
+    for (; i + 3 <= i1; i += 4) {
+      const size_t idx = row + size_t(i);
+      const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&cellX_[idx]), vpx);
+      const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&cellY_[idx]), vpy);
+      const __m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+      const __m128 thr = _mm_max_ps(vminDist, _mm_loadu_ps(&cellR_[idx]));
+      const int close = _mm_movemask_ps(_mm_cmplt_ps(distSq, _mm_mul_ps(thr, thr)));
+      if (close) {
+        // unoccupied cells hold stale coordinates - mask them out
+        const int occ = int(occupied_[idx] != 0) | (int(occupied_[idx + 1] != 0) << 1) | (int(occupied_[idx + 2] != 0) << 2) |
+                        (int(occupied_[idx + 3] != 0) << 3);
+        if (close & occ)
+          return true;
+      }
+    }
+#endif // POISSON_SIMD_SSE2
+    for (; i <= i1; i++) {
+      const size_t idx = row + size_t(i);
+      if (isOccupied(idx)) {
+        const float dx = cellX_[idx] - px;
+        const float dy = cellY_[idx] - py;
+        const float thr = minDist > cellR_[idx] ? minDist : cellR_[idx];
+        if (dx * dx + dy * dy < thr * thr)
+          return true;
+      }
+    }
+    return false;
+  }
+
  private:
   int w_;
   int h_;
   float cellSize_;
-  std::vector<std::vector<Point>> grid_;
+  float maxRadius_ = 0.0f;
+  std::vector<float> cellX_;
+  std::vector<float> cellY_;
+  std::vector<float> cellR_;
+  std::vector<uint8_t> cellClass_;
+  std::vector<uint8_t> occupied_;
 };
 
 template<typename PRNG>
 Point popRandom(std::vector<Point>& points, PRNG& generator) {
   const int idx = generator.randomInt(static_cast<int>(points.size()) - 1);
   const Point p = points[idx];
-  points.erase(points.begin() + idx);
+  // swap-with-back keeps removal O(1); the active list is an unordered set, so the order does not matter
+  points[idx] = points.back();
+  points.pop_back();
   return p;
 }
 
@@ -183,190 +493,2667 @@ Point generateRandomPointAround(const Point& p, float minDist, PRNG& generator)
   return Point(x, y);
 }
 
+// stack buffer size for batched candidate generation; larger batches are processed in chunks
+const uint32_t kCandidateBatchSize = 64;
+
+// give up seeding a sampler after this many rejected dart throws - a degenerate domain
+// or an all-zero density map then produces an empty set instead of an endless loop
+const uint32_t kMaxSeedAttempts = 65536;
+
+// polynomial sin approximation on [-pi, pi]; ~0.001 absolute error is plenty for
+// dart throwing, and the branch-free body lets the candidate loop auto-vectorize
+inline float fastSin(float x) {
+  const float kPi = 3.141592653589f;
+  const float y = (4.0f / kPi) * x - (4.0f / (kPi * kPi)) * x * fabsf(x);
+  return 0.225f * (y * fabsf(y) - y) + y;
+}
+
 /**
-   Return a vector of generated points
+   Batched generateRandomPointAround(): fill 'out' with 'count' candidates around 'p'
+   in one call. The PRNG draws are split from the trig so the second loop has no
+   loop-carried dependency and vectorizes, and the libm sin/cos pair per candidate
+   is replaced with a polynomial sincos - at 'newPointsCount' candidates per accepted
+   point the trig is a significant slice of the generation profile
+**/
+template<typename PRNG>
+void generateRandomPointsAround(const Point& p, float minDist, PRNG& generator, Point* out, uint32_t count) {
+  const float kPi = 3.141592653589f;
+
+  // stash (radius, angle) in the output buffer so the trig loop below is PRNG-free
+  for (uint32_t i = 0; i != count; i++) {
+    const float R1 = generator.randomFloat();
+    const float R2 = generator.randomFloat();
+    // radius should be between MinDist and 2 * MinDist
+    out[i].x = minDist * (R1 + 1.0f);
+    // random angle in [-pi, pi)
+    out[i].y = 2.0f * kPi * R2 - kPi;
+  }
 
-   NewPointsCount - refer to bridson-siggraph07-poissondisk.pdf for details (the value 'k')
-   Circle  - 'true' to fill a circle, 'false' to fill a rectangle
-   MinDist - minimal distance estimator, use negative value for default
+  for (uint32_t i = 0; i != count; i++) {
+    const float radius = out[i].x;
+    const float angle = out[i].y;
+    // cos(a) = sin(a + pi/2), wrapped back into [-pi, pi]
+    const float shifted = angle + 0.5f * kPi;
+    const float cosAngle = fastSin(shifted > kPi ? shifted - 2.0f * kPi : shifted);
+    out[i] = Point(p.x + radius * cosAngle, p.y + radius * fastSin(angle));
+  }
+}
+
+/**
+   Upper bound on how many minDist-separated points fit into the unit domain:
+   hexagonal packing density - the densest possible arrangement - over the domain
+   area (pi/4 for the circle, 1 for the square), plus one boundary row of slack.
+   Sizing containers from min(request, capacity) keeps the upfront allocation
+   single-shot without over-reserving when a coarse minDist caps the set far below
+   the requested count
+**/
+inline uint32_t estimatePoissonPointCapacity(float minDist, bool isCircle) {
+  if (minDist <= 0.0f)
+    return 0;
+
+  const double area = isCircle ? 0.785398163397448309616 : 1.0; // PI/4 for the circle domain
+
+  // 2 / (sqrt(3) * minDist^2) points per unit area at hexagonal packing
+  const double capacity = 2.0 * area / (1.7320508075688772 * double(minDist) * double(minDist)) + 2.0 / double(minDist);
+
+  return capacity > 4294967294.0 ? 0xffffffffu : uint32_t(ceil(capacity)) + 1;
+}
+
+/**
+   Incremental resumable Bridson sampler - the grid, active list and PRNG of
+   generatePoissonPoints() wrapped into a stateful object
+
+   Call step() repeatedly to grow the point set in batches (progressive preview,
+   cancellation between batches); snapshot() / PoissonSampler(snapshot) checkpoint
+   and resume a long-running generation. The PRNG type must be copyable and
+   reconstructible from getSeed(), as DefaultPRNG is.
+   generatePoissonPoints() is a thin wrapper over this class
 **/
 template<typename PRNG = DefaultPRNG>
-std::vector<Point> generatePoissonPoints(uint32_t numPoints,
-                                         PRNG& generator,
-                                         bool isCircle = true,
-                                         uint32_t newPointsCount = 30,
-                                         float minDist = -1.0f) {
-  numPoints *= 2;
+class PoissonSampler {
+ public:
+  struct Snapshot {
+    uint32_t seed = 0;
+    uint32_t targetNumPoints = 0;
+    uint32_t newPointsCount = 30;
+    float minDist = -1.0f;
+    bool isCircle = true;
+    std::vector<Point> samplePoints;
+    std::vector<Point> processList;
+  };
+
+  PoissonSampler(uint32_t numPoints,
+                 const PRNG& generator,
+                 bool isCircle = true,
+                 uint32_t newPointsCount = 30,
+                 float minDist = -1.0f,
+                 const DensityMap& densityMap = DensityMap(),
+                 uint32_t maxPoints = 0)
+      : generator_(generator)
+      , isCircle_(isCircle)
+      , newPointsCount_(newPointsCount)
+      , targetNumPoints_(scaleNumPoints(numPoints, isCircle))
+      , minDist_(defaultMinDist(targetNumPoints_, minDist))
+      , cellSize_(minDist_ / sqrt(2.0f))
+      , grid_((int)ceil(1.0f / cellSize_), (int)ceil(1.0f / cellSize_), cellSize_)
+      , densityMap_(densityMap)
+      , maxPoints_(maxPoints) {
+    if (!targetNumPoints_)
+      return;
+
+    reserveContainers();
+
+    // a density map that is zero everywhere the domain reaches would otherwise spin
+    // forever - bound the search; giving up leaves the sampler done with an empty set
+    for (uint32_t attempt = 0; attempt != kMaxSeedAttempts; attempt++) {
+      const Point firstPoint(generator_.randomFloat(), generator_.randomFloat());
+
+      if (!(isCircle_ ? firstPoint.isInCircle() : firstPoint.isInRectangle()) || localMinDist(firstPoint) <= 0.0f)
+        continue;
 
-  // if we want to generate a Poisson square shape, multiply the estimate number of points by PI/4 due to reduced shape area
-  if (!isCircle) {
-    const double Pi_4 = 0.785398163397448309616; // PI/4
-    numPoints = static_cast<int>(Pi_4 * numPoints);
+      // update containers
+      processList_.push_back(firstPoint);
+      samplePoints_.push_back(firstPoint);
+      insertIntoGrid(firstPoint);
+      break;
+    }
   }
 
-  if (minDist < 0.0f) {
-    minDist = sqrt(float(numPoints)) / float(numPoints);
-  }
+  // sample a user-supplied domain: the seed point is drawn against 'domain' and the same
+  // domain object has to be passed to every step(maxNewPoints, domain) call
+  template<typename DOMAIN>
+  PoissonSampler(uint32_t numPoints,
+                 const PRNG& generator,
+                 const DOMAIN& domain,
+                 uint32_t newPointsCount = 30,
+                 float minDist = -1.0f,
+                 const DensityMap& densityMap = DensityMap())
+      : generator_(generator)
+      , isCircle_(false)
+      , newPointsCount_(newPointsCount)
+      , targetNumPoints_(scaleNumPoints(numPoints, false))
+      , minDist_(defaultMinDist(targetNumPoints_, minDist))
+      , cellSize_(minDist_ / sqrt(2.0f))
+      , grid_((int)ceil(1.0f / cellSize_), (int)ceil(1.0f / cellSize_), cellSize_)
+      , densityMap_(densityMap) {
+    if (!targetNumPoints_)
+      return;
+
+    reserveContainers();
+
+    // bounded like the shape-flag constructor: an empty domain or an all-zero density
+    // map yields an empty set instead of an endless seed search
+    for (uint32_t attempt = 0; attempt != kMaxSeedAttempts; attempt++) {
+      const Point firstPoint(generator_.randomFloat(), generator_.randomFloat());
+
+      if (!domain.isInside(firstPoint) || localMinDist(firstPoint) <= 0.0f)
+        continue;
 
-  std::vector<Point> samplePoints;
-  std::vector<Point> processList;
+      processList_.push_back(firstPoint);
+      samplePoints_.push_back(firstPoint);
+      insertIntoGrid(firstPoint);
+      break;
+    }
+  }
 
-  if (!numPoints)
-    return samplePoints;
+  // resume from a checkpoint taken with snapshot(); the density map is not owned by
+  // the snapshot and has to be passed in again
+  explicit PoissonSampler(const Snapshot& snapshot, const DensityMap& densityMap = DensityMap())
+      : generator_(PRNG(snapshot.seed))
+      , isCircle_(snapshot.isCircle)
+      , newPointsCount_(snapshot.newPointsCount)
+      , targetNumPoints_(snapshot.targetNumPoints)
+      , minDist_(snapshot.minDist)
+      , cellSize_(minDist_ / sqrt(2.0f))
+      , grid_((int)ceil(1.0f / cellSize_), (int)ceil(1.0f / cellSize_), cellSize_)
+      , densityMap_(densityMap)
+      , samplePoints_(snapshot.samplePoints)
+      , processList_(snapshot.processList) {
+    // the grid is not serialized - rebuild it from the accepted points
+    for (const Point& p : samplePoints_)
+      insertIntoGrid(p);
+  }
 
-  // create the grid
-  const float cellSize = minDist / sqrt(2.0f);
+  // run the Bridson loop until 'maxNewPoints' more points are emitted or generation is
+  // complete; returns the number of points added (it can be 0 even before isDone());
+  // a single dispatch on the shape here keeps the candidate loop branch-free
+  uint32_t step(uint32_t maxNewPoints) {
+    return isCircle_ ? step(maxNewPoints, CircleDomain()) : step(maxNewPoints, SquareDomain());
+  }
 
-  const int gridW = (int)ceil(1.0f / cellSize);
-  const int gridH = (int)ceil(1.0f / cellSize);
+  // same, against a compile-time domain policy - pass the domain the sampler was constructed with
+  template<typename DOMAIN>
+  uint32_t step(uint32_t maxNewPoints, const DOMAIN& domain) {
+    const size_t sizeBefore = samplePoints_.size();
 
-  Grid grid(gridW, gridH, cellSize);
+    // generate new points for each point in the queue
+    while (!isDone() && samplePoints_.size() - sizeBefore < maxNewPoints) {
+      const Point point = popRandom<PRNG>(processList_, generator_);
 
-  Point firstPoint;
-  do {
-    firstPoint = Point(generator.randomFloat(), generator.randomFloat());
-  } while (!(isCircle ? firstPoint.isInCircle() : firstPoint.isInRectangle()));
+      const float parentMinDist = localMinDist(point);
 
-  // update containers
-  processList.push_back(firstPoint);
-  samplePoints.push_back(firstPoint);
-  grid.insert(firstPoint);
+      Point candidates[kCandidateBatchSize];
 
-#if POISSON_PROGRESS_INDICATOR
-  size_t progress = 0;
-#endif
+      for (uint32_t numLeft = newPointsCount_; numLeft;) {
+        const uint32_t batch = numLeft < kCandidateBatchSize ? numLeft : kCandidateBatchSize;
+        generateRandomPointsAround(point, parentMinDist, generator_, candidates, batch);
+        numCandidatesTried_ += batch;
+        numLeft -= batch;
 
-  // generate new points for each point in the queue
-  while (!processList.empty() && samplePoints.size() <= numPoints) {
-#if POISSON_PROGRESS_INDICATOR
-    // a progress indicator, kind of
-    if ((samplePoints.size()) % 1000 == 0) {
-      const size_t newProgress = 200 * (samplePoints.size() + processList.size()) / numPoints;
-      if (newProgress != progress) {
-        progress = newProgress;
-        std::cout << ".";
-      }
-    }
-#endif // POISSON_PROGRESS_INDICATOR
+        for (uint32_t i = 0; i < batch; i++) {
+          const Point& newPoint = candidates[i];
 
-    const Point point = popRandom<PRNG>(processList, generator);
+          if (!domain.isInside(newPoint))
+            continue;
 
-    for (uint32_t i = 0; i < newPointsCount; i++) {
-      const Point newPoint = generateRandomPointAround(point, minDist, generator);
-      const bool canFitPoint = isCircle ? newPoint.isInCircle() : newPoint.isInRectangle();
+          const float newMinDist = localMinDist(newPoint);
 
-      if (canFitPoint && !grid.isInNeighbourhood(newPoint, minDist, cellSize)) {
-        processList.push_back(newPoint);
-        samplePoints.push_back(newPoint);
-        grid.insert(newPoint);
-        continue;
+          if (newMinDist > 0.0f && !grid_.isInNeighbourhood(newPoint, newMinDist, cellSize_)) {
+            processList_.push_back(newPoint);
+            samplePoints_.push_back(newPoint);
+            insertIntoGrid(newPoint);
+            // the hard cap is strict - stop mid-batch instead of overshooting
+            if (maxPoints_ && numDrainedPoints_ + samplePoints_.size() >= maxPoints_)
+              return uint32_t(samplePoints_.size() - sizeBefore);
+            continue;
+          }
+        }
       }
     }
-  }
-
-#if POISSON_PROGRESS_INDICATOR
-  std::cout << std::endl << std::endl;
-#endif // POISSON_PROGRESS_INDICATOR
-
-  return samplePoints;
-}
 
-Point sampleVogelDisk(uint32_t idx, uint32_t numPoints, float phi) {
-  const float kGoldenAngle = 2.4f;
+    return uint32_t(samplePoints_.size() - sizeBefore);
+  }
 
-  const float r = sqrtf(float(idx) + 0.5f) / sqrtf(float(numPoints));
-  const float theta = idx * kGoldenAngle + phi;
+  bool isDone() const {
+    if (maxPoints_ && numDrainedPoints_ + samplePoints_.size() >= maxPoints_)
+      return true;
+    return processList_.empty() || numDrainedPoints_ + samplePoints_.size() > targetNumPoints_;
+  }
 
-  return Point(r * cosf(theta), r * sinf(theta));
-}
+  // hand all accepted-but-undelivered points to 'callback(const Point*, uint32_t)' and drop
+  // them from the resident vector; the grid keeps their coordinates, so sampling quality is
+  // unaffected and a drained sampler holds at most one chunk of points plus the active list.
+  // snapshot() and takePoints() after a drain cover only the still-resident points
+  template<typename CALLBACK>
+  uint32_t drainPoints(CALLBACK&& callback) {
+    const uint32_t numDelivered = uint32_t(samplePoints_.size());
+
+    if (numDelivered)
+      callback(samplePoints_.data(), numDelivered);
+
+    if (!numDrainedPoints_) {
+      // release the full-target reservation made by the constructor - from now on the
+      // vector re-grows once to roughly the drain cadence and stays there
+      std::vector<Point>().swap(samplePoints_);
+    } else {
+      samplePoints_.clear();
+    }
 
-/**
-   Return a vector of generated points
-**/
-std::vector<Point> generateVogelPoints(uint32_t numPoints, bool isCircle = true, float phi = 0.0f, Point center = Point(0.5f, 0.5f)) {
-  std::vector<Point> samplePoints;
+    numDrainedPoints_ += numDelivered;
 
-  samplePoints.reserve(numPoints);
+    return numDelivered;
+  }
 
-  const uint32_t numSamples = isCircle ? 4 * numPoints : numPoints;
+  // points accepted so far, including points already handed out by drainPoints()
+  size_t numPoints() const {
+    return numDrainedPoints_ + samplePoints_.size();
+  }
 
-  for (uint32_t i = 0; i != numPoints; i++) {
-    const Point p = sampleVogelDisk(i, numSamples, phi * 3.141592653f / 180.0f) + center;
-    samplePoints.push_back(p);
+  Snapshot snapshot() const {
+    Snapshot s;
+    s.seed = generator_.getSeed();
+    s.targetNumPoints = targetNumPoints_;
+    s.newPointsCount = newPointsCount_;
+    s.minDist = minDist_;
+    s.isCircle = isCircle_;
+    s.samplePoints = samplePoints_;
+    s.processList = processList_;
+    return s;
   }
 
-  return samplePoints;
-}
+  const std::vector<Point>& points() const {
+    return samplePoints_;
+  }
+  std::vector<Point> takePoints() {
+    return std::move(samplePoints_);
+  }
+  const PRNG& generator() const {
+    return generator_;
+  }
+  size_t numActivePoints() const {
+    return processList_.size();
+  }
+  uint32_t targetNumPoints() const {
+    return targetNumPoints_;
+  }
+  // total dart throws so far; the candidate-rejection rate is 1 - points()/numCandidatesTried()
+  uint64_t numCandidatesTried() const {
+    return numCandidatesTried_;
+  }
 
-/**
-   Return a vector of generated points
-**/
-template<typename PRNG = DefaultPRNG>
-std::vector<Point> generateJitteredGridPoints(uint32_t numPoints,
-                                              PRNG& generator,
-                                              bool isCircle = false,
-                                              float jitterRadius = 0.004f,
-                                              Point center = Point(0.5f, 0.5f)) {
-  std::vector<Point> samplePoints;
+ private:
+  // the minimal distance around 'p': the base minDist where density is 1, growing as
+  // 1/sqrt(density) in sparser areas (capped at 10x); <= 0 means "no points here"
+  float localMinDist(const Point& p) const {
+    if (!densityMap_.data)
+      return minDist_;
 
-  samplePoints.reserve(numPoints);
+    const float density = densityMap_.sample(p);
 
-  const uint32_t gridSize = uint32_t(sqrt(numPoints));
+    if (density <= 0.0f)
+      return 0.0f;
 
-  for (uint32_t x = 0; x != gridSize; x++) {
-    for (uint32_t y = 0; y != gridSize; y++) {
-      Point p;
-      do {
-        const Point offs = generateRandomPointAround(Point(0, 0), jitterRadius, generator) - center + Point(0.5f, 0.5f);
-        p = Point(float(x) / gridSize, float(y) / gridSize) + offs;
-        // generate a new point until it is within the boundaries
-      } while (!p.isInRectangle());
+    const float kMinDensity = 0.01f;
+    return minDist_ / sqrt(density > kMinDensity ? density : kMinDensity);
+  }
+  void insertIntoGrid(const Point& p) {
+    // uniform sampling keeps the per-point radius at 0 so the query distance alone decides
+    grid_.insert(p, densityMap_.data ? localMinDist(p) : 0.0f);
+  }
+  // one upfront allocation per container instead of log(n) reallocate-and-copy cycles
+  // (repeated 100MB+ copies and a transient 2x peak for 10M-point sets): sized by the
+  // request, but never beyond what can physically pack at minDist_ or beyond the hard
+  // cap, so a coarse minDist or a capped job does not reserve memory it can never fill.
+  // Density maps can locally shrink the radius below minDist_ and outgrow the packing
+  // estimate - the vectors then fall back to geometric growth
+  void reserveContainers() {
+    uint32_t capacity = targetNumPoints_;
+
+    const uint32_t packingBound = estimatePoissonPointCapacity(minDist_, isCircle_);
+    if (packingBound && packingBound < capacity)
+      capacity = packingBound;
+    if (maxPoints_ && maxPoints_ < capacity)
+      capacity = maxPoints_;
+
+    // the inner loop can overshoot the target by up to newPointsCount_ accepted candidates
+    samplePoints_.reserve(size_t(capacity) + newPointsCount_);
+    processList_.reserve(size_t(capacity) + newPointsCount_);
+  }
+  static uint32_t scaleNumPoints(uint32_t numPoints, bool isCircle) {
+    numPoints *= 2;
 
-      if (isCircle)
-        if (!p.isInCircle())
-          continue;
+    // if we want to generate a Poisson square shape, multiply the estimate number of points by PI/4 due to reduced shape area
+    if (!isCircle) {
+      const double Pi_4 = 0.785398163397448309616; // PI/4
+      numPoints = static_cast<int>(Pi_4 * numPoints);
+    }
 
-      samplePoints.push_back(p);
+    return numPoints;
+  }
+  static float defaultMinDist(uint32_t numPoints, float minDist) {
+    if (minDist < 0.0f) {
+      minDist = numPoints ? sqrt(float(numPoints)) / float(numPoints) : 1.0f;
     }
+    return minDist;
   }
 
-  return samplePoints;
-}
+ private:
+  PRNG generator_;
+  bool isCircle_;
+  uint32_t newPointsCount_;
+  uint32_t targetNumPoints_;
+  float minDist_;
+  float cellSize_;
+  Grid grid_;
+  DensityMap densityMap_;
+  std::vector<Point> samplePoints_;
+  std::vector<Point> processList_;
+  uint64_t numCandidatesTried_ = 0;
+  uint64_t numDrainedPoints_ = 0;
+  uint32_t maxPoints_ = 0; // strict upper bound on accepted points; 0 = uncapped
+};
 
 namespace {
 
-// http://holger.dammertz.org/stuff/notes_HammersleyOnHemisphere.html
-float radicalInverse_VdC(uint32_t bits) {
-  bits = (bits << 16u) | (bits >> 16u);
-  bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
-  bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
-  bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
-  bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
-  return float(float(bits) * 2.3283064365386963e-10); // / 0x100000000
-}
+// caller-buffer output sinks - no Point::valid_ padding in the output representation
+
+// packed x,y float pairs (2 * capacity floats)
+struct OutputBufferXY {
+  float* xy;
+  uint32_t capacity;
+  uint32_t count;
+  void operator()(float x, float y) {
+    if (count < capacity) {
+      xy[2 * count + 0] = x;
+      xy[2 * count + 1] = y;
+      count++;
+    }
+  }
+};
 
-Point hammersley2d(uint32_t i, uint32_t N) {
-  return Point(float(i) / float(N), radicalInverse_VdC(i));
-}
+// separate SoA x[] / y[] planes (capacity floats each)
+struct OutputBufferSoA {
+  float* x;
+  float* y;
+  uint32_t capacity;
+  uint32_t count;
+  void operator()(float px, float py) {
+    if (count < capacity) {
+      x[count] = px;
+      y[count] = py;
+      count++;
+    }
+  }
+};
+
+struct OutputVector {
+  std::vector<Point>* points;
+  void operator()(float x, float y) {
+    points->push_back(Point(x, y));
+  }
+};
 
 } // namespace
 
 /**
    Return a vector of generated points
-**/
-std::vector<Point> generateHammersleyPoints(uint32_t numPoints) {
-  std::vector<Point> samplePoints;
 
-  samplePoints.reserve(numPoints);
+   NewPointsCount - refer to bridson-siggraph07-poissondisk.pdf for details (the value 'k')
+   Circle  - 'true' to fill a circle, 'false' to fill a rectangle
+   MinDist - minimal distance estimator, use negative value for default
+   DensityMap - optional density map over the unit square for variable-radius sampling
+   MaxPoints - optional strict cap on the number of accepted points (0 = uncapped); with
+   a cap both the point count and the peak allocation are flat and predictable
+**/
+template<typename PRNG = DefaultPRNG>
+std::vector<Point> generatePoissonPoints(uint32_t numPoints,
+                                         PRNG& generator,
+                                         bool isCircle = true,
+                                         uint32_t newPointsCount = 30,
+                                         float minDist = -1.0f,
+                                         const DensityMap& densityMap = DensityMap(),
+                                         uint32_t maxPoints = 0) {
+  PoissonSampler<PRNG> sampler(numPoints, generator, isCircle, newPointsCount, minDist, densityMap, maxPoints);
 
-  const uint32_t gridSize = uint32_t(sqrt(numPoints));
+#if POISSON_PROGRESS_INDICATOR
+  size_t progress = 0;
+#endif
 
-  for (uint32_t i = 0; i != numPoints; i++) {
-    Point p = hammersley2d(i, numPoints);
+  while (!sampler.isDone()) {
+    sampler.step(1000);
 
-    samplePoints.push_back(p);
+#if POISSON_PROGRESS_INDICATOR
+    // a progress indicator, kind of
+    const size_t newProgress = 200 * (sampler.points().size() + sampler.numActivePoints()) / sampler.targetNumPoints();
+    if (newProgress != progress) {
+      progress = newProgress;
+      std::cout << ".";
+    }
+#endif // POISSON_PROGRESS_INDICATOR
   }
-  return samplePoints;
+
+#if POISSON_PROGRESS_INDICATOR
+  std::cout << std::endl << std::endl;
+#endif // POISSON_PROGRESS_INDICATOR
+
+  // propagate the advanced PRNG state back to the caller
+  generator = sampler.generator();
+
+  return sampler.takePoints();
+}
+
+// generation statistics reported to a progress observer
+struct SampleStats {
+  size_t numPoints = 0; // accepted points so far
+  size_t numActivePoints = 0; // current size of the active list; near-zero long before the target is a dying run
+  uint32_t targetNumPoints = 0;
+  uint64_t numCandidatesTried = 0; // the acceptance rate is numPoints / numCandidatesTried
+  double elapsedSeconds = 0.0;
+};
+
+// observer stub for generic call sites; report() is a no-op that inlines away
+struct NullObserver {
+  uint32_t cadence() const {
+    return 0; // 0 = default batching
+  }
+  void report(const SampleStats&) {}
+};
+
+/**
+   Same, reporting SampleStats to 'observer' every observer.cadence() accepted points -
+   drives service-side progress reporting and catches pathological density-map configs
+   early (stalling acceptance rate, starved active list) instead of after a full run.
+   Any class type with cadence() and report(const SampleStats&) works (the class-type
+   constraint keeps this overload out of resolution for the buffer-output entries);
+   the observer sits outside the per-candidate loop, and the observer-free overloads
+   are untouched - POISSON_PROGRESS_INDICATOR remains for the simple stdout dots
+**/
+template<typename PRNG = DefaultPRNG,
+         typename OBSERVER = NullObserver,
+         typename = typename std::enable_if<std::is_class<OBSERVER>::value>::type>
+std::vector<Point> generatePoissonPoints(uint32_t numPoints,
+                                         PRNG& generator,
+                                         OBSERVER& observer,
+                                         bool isCircle = true,
+                                         uint32_t newPointsCount = 30,
+                                         float minDist = -1.0f,
+                                         const DensityMap& densityMap = DensityMap()) {
+  PoissonSampler<PRNG> sampler(numPoints, generator, isCircle, newPointsCount, minDist, densityMap);
+
+  const uint32_t cadence = observer.cadence() ? observer.cadence() : 1000;
+  const auto start = std::chrono::steady_clock::now();
+
+  while (!sampler.isDone()) {
+    sampler.step(cadence);
+
+    SampleStats stats;
+    stats.numPoints = sampler.points().size();
+    stats.numActivePoints = sampler.numActivePoints();
+    stats.targetNumPoints = sampler.targetNumPoints();
+    stats.numCandidatesTried = sampler.numCandidatesTried();
+    stats.elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count();
+    observer.report(stats);
+  }
+
+  // propagate the advanced PRNG state back to the caller
+  generator = sampler.generator();
+
+  return sampler.takePoints();
+}
+
+/**
+   Same, but writing packed x,y pairs into a caller-provided buffer (2 * capacity floats) -
+   e.g. a mapped GPU staging buffer - with no Point padding and no repack pass.
+   Returns the number of points written
+**/
+template<typename PRNG = DefaultPRNG>
+uint32_t generatePoissonPoints(uint32_t numPoints,
+                               PRNG& generator,
+                               float* outXY,
+                               uint32_t capacity,
+                               bool isCircle = true,
+                               uint32_t newPointsCount = 30,
+                               float minDist = -1.0f,
+                               const DensityMap& densityMap = DensityMap()) {
+  // step(0) makes no progress, so an empty buffer would loop forever
+  if (!capacity)
+    return 0;
+
+  PoissonSampler<PRNG> sampler(numPoints, generator, isCircle, newPointsCount, minDist, densityMap);
+
+  while (!sampler.isDone())
+    sampler.step(capacity);
+
+  generator = sampler.generator();
+
+  OutputBufferXY output = {outXY, capacity, 0};
+  for (const Point& p : sampler.points())
+    output(p.x, p.y);
+  return output.count;
+}
+
+/**
+   Same, but writing into separate caller-provided SoA x[] / y[] planes (capacity floats each).
+   Returns the number of points written
+**/
+template<typename PRNG = DefaultPRNG>
+uint32_t generatePoissonPoints(uint32_t numPoints,
+                               PRNG& generator,
+                               float* outX,
+                               float* outY,
+                               uint32_t capacity,
+                               bool isCircle = true,
+                               uint32_t newPointsCount = 30,
+                               float minDist = -1.0f,
+                               const DensityMap& densityMap = DensityMap()) {
+  // step(0) makes no progress, so an empty buffer would loop forever
+  if (!capacity)
+    return 0;
+
+  PoissonSampler<PRNG> sampler(numPoints, generator, isCircle, newPointsCount, minDist, densityMap);
+
+  while (!sampler.isDone())
+    sampler.step(capacity);
+
+  generator = sampler.generator();
+
+  OutputBufferSoA output = {outX, outY, capacity, 0};
+  for (const Point& p : sampler.points())
+    output(p.x, p.y);
+  return output.count;
+}
+
+/**
+   Chunked generation for pipelining: 'callback(const Point* points, uint32_t count)' is
+   invoked with spans of roughly 'chunkSize' accepted points while generation is still
+   running, so downstream stages (rasterize, encode with savePointsBinary(), upload)
+   overlap with sampling instead of waiting for the complete set. Resident memory is
+   bounded by one chunk plus the sampler grid rather than the whole vector. Chunking
+   consumes no extra PRNG draws - the concatenated spans are exactly the
+   generatePoissonPoints() output for the same arguments. Returns the total number of
+   points delivered
+**/
+template<typename PRNG, typename CALLBACK>
+uint64_t generatePoissonPointsChunked(uint32_t numPoints,
+                                      PRNG& generator,
+                                      CALLBACK&& callback,
+                                      uint32_t chunkSize = 65536,
+                                      bool isCircle = true,
+                                      uint32_t newPointsCount = 30,
+                                      float minDist = -1.0f,
+                                      const DensityMap& densityMap = DensityMap()) {
+  PoissonSampler<PRNG> sampler(numPoints, generator, isCircle, newPointsCount, minDist, densityMap);
+
+  if (!chunkSize)
+    chunkSize = 1;
+
+  uint64_t numDelivered = 0;
+
+  while (!sampler.isDone()) {
+    sampler.step(chunkSize - uint32_t(sampler.points().size()));
+
+    // step() can stop short of the cadence (dying active list) or overshoot it by up to
+    // newPointsCount - flush whenever at least one full chunk is resident
+    if (sampler.points().size() >= chunkSize)
+      numDelivered += sampler.drainPoints(callback);
+  }
+
+  numDelivered += sampler.drainPoints(callback);
+
+  generator = sampler.generator();
+
+  return numDelivered;
+}
+
+namespace {
+
+// run Bridson sampling restricted to one tile of the domain, reading/writing the shared grid;
+// safe without locks because the caller only runs tiles whose scan windows cannot overlap
+template<typename PRNG, typename DOMAIN>
+void samplePoissonTile(Grid& grid,
+                       std::vector<Point>& tilePoints,
+                       PRNG generator,
+                       const Point& tileMin,
+                       const Point& tileMax,
+                       const DOMAIN& domain,
+                       uint32_t newPointsCount,
+                       float minDist,
+                       float cellSize) {
+  std::vector<Point> processList;
+
+  // at most one point per grid cell can land in the tile - size both lists once from that bound
+  const float tileArea = (tileMax.x - tileMin.x) * (tileMax.y - tileMin.y);
+  const size_t maxTilePoints = size_t(tileArea / (cellSize * cellSize)) + 1;
+  processList.reserve(maxTilePoints);
+  tilePoints.reserve(maxTilePoints);
+
+  // seed the tile with initial darts; Bridson flood fill covers the rest of the tile
+  for (uint32_t i = 0; i != newPointsCount; i++) {
+    const Point p(tileMin.x + (tileMax.x - tileMin.x) * generator.randomFloat(),
+                  tileMin.y + (tileMax.y - tileMin.y) * generator.randomFloat());
+
+    if (!domain.isInside(p))
+      continue;
+
+    if (grid.isInNeighbourhood(p, minDist, cellSize))
+      continue;
+
+    processList.push_back(p);
+    tilePoints.push_back(p);
+    grid.insert(p);
+  }
+
+  while (!processList.empty()) {
+    const Point point = popRandom<PRNG>(processList, generator);
+
+    Point candidates[kCandidateBatchSize];
+
+    for (uint32_t numLeft = newPointsCount; numLeft;) {
+      const uint32_t batch = numLeft < kCandidateBatchSize ? numLeft : kCandidateBatchSize;
+      generateRandomPointsAround(point, minDist, generator, candidates, batch);
+      numLeft -= batch;
+
+      for (uint32_t i = 0; i < batch; i++) {
+        const Point& newPoint = candidates[i];
+        const bool isInTile = newPoint.x >= tileMin.x && newPoint.x < tileMax.x && newPoint.y >= tileMin.y && newPoint.y < tileMax.y;
+        const bool canFitPoint = isInTile && domain.isInside(newPoint);
+
+        if (canFitPoint && !grid.isInNeighbourhood(newPoint, minDist, cellSize)) {
+          processList.push_back(newPoint);
+          tilePoints.push_back(newPoint);
+          grid.insert(newPoint);
+          continue;
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+/**
+   Return a vector of generated points, sampled in parallel over a checkerboard of domain tiles
+
+   The domain is split into tiles processed in 4 phases so that concurrently running tiles are
+   always farther apart than the grid scan window - the shared grid then needs no locks and the
+   minimum-distance guarantee holds across tile seams. Each tile draws from its own PRNG stream
+   derived from the seed of 'generator', the tile layout does not depend on 'numThreads', and
+   tiles are committed in a fixed order, so the output is reproducible for any thread count
+**/
+template<typename PRNG = DefaultPRNG>
+std::vector<Point> generatePoissonPointsParallel(uint32_t numPoints,
+                                                 PRNG& generator,
+                                                 uint32_t numThreads,
+                                                 bool isCircle = true,
+                                                 uint32_t newPointsCount = 30,
+                                                 float minDist = -1.0f) {
+  const uint32_t requestedPoints = numPoints;
+  const float requestedMinDist = minDist;
+
+  numPoints *= 2;
+
+  // if we want to generate a Poisson square shape, multiply the estimate number of points by PI/4 due to reduced shape area
+  if (!isCircle) {
+    const double Pi_4 = 0.785398163397448309616; // PI/4
+    numPoints = static_cast<int>(Pi_4 * numPoints);
+  }
+
+  if (minDist < 0.0f) {
+    minDist = sqrt(float(numPoints)) / float(numPoints);
+  }
+
+  std::vector<Point> samplePoints;
+
+  if (!numPoints)
+    return samplePoints;
+
+  // create the grid
+  const float cellSize = minDist / sqrt(2.0f);
+
+  const int gridW = (int)ceil(1.0f / cellSize);
+  const int gridH = (int)ceil(1.0f / cellSize);
+
+  // a tile must span at least 2x the scan window so that same-phase tiles can never
+  // read cells another tile is writing; derive the layout from the grid alone to keep
+  // the output independent of the thread count
+  int tilesPerSide = gridW / (2 * Grid::scanCells(minDist, cellSize));
+  if (tilesPerSide > 32)
+    tilesPerSide = 32;
+
+  if (numThreads <= 1 || tilesPerSide < 2)
+    return generatePoissonPoints(requestedPoints, generator, isCircle, newPointsCount, requestedMinDist);
+
+  Grid grid(gridW, gridH, cellSize);
+
+  std::vector<std::vector<Point>> tilePoints(size_t(tilesPerSide) * size_t(tilesPerSide));
+
+  const uint32_t seedBase = generator.getSeed();
+
+  // 4-phase checkerboard: phase (px, py) runs tiles with (tx % 2, ty % 2) == (px, py)
+  for (int phase = 0; phase != 4; phase++) {
+    std::vector<int> jobs;
+    for (int ty = phase / 2; ty < tilesPerSide; ty += 2)
+      for (int tx = phase % 2; tx < tilesPerSide; tx += 2)
+        jobs.push_back(ty * tilesPerSide + tx);
+
+    std::atomic<size_t> nextJob(0);
+
+    auto worker = [&]() {
+      for (size_t j = nextJob++; j < jobs.size(); j = nextJob++) {
+        const int t = jobs[j];
+        const int tx = t % tilesPerSide;
+        const int ty = t / tilesPerSide;
+        const Point tileMin(float(tx) / tilesPerSide, float(ty) / tilesPerSide);
+        const Point tileMax(float(tx + 1) / tilesPerSide, float(ty + 1) / tilesPerSide);
+        // an independent, reproducible PRNG stream per tile; one shape dispatch per tile
+        PRNG tileGenerator(seedBase + uint32_t(t) * 2654435761u);
+        if (isCircle)
+          samplePoissonTile(grid, tilePoints[t], tileGenerator, tileMin, tileMax, CircleDomain(), newPointsCount, minDist, cellSize);
+        else
+          samplePoissonTile(grid, tilePoints[t], tileGenerator, tileMin, tileMax, SquareDomain(), newPointsCount, minDist, cellSize);
+      }
+    };
+
+    const size_t poolSize = numThreads < jobs.size() ? numThreads : jobs.size();
+
+    std::vector<std::thread> pool;
+    pool.reserve(poolSize);
+    for (size_t i = 0; i != poolSize; i++)
+      pool.emplace_back(worker);
+    for (auto& thread : pool)
+      thread.join();
+  }
+
+  size_t totalPoints = 0;
+  for (const auto& points : tilePoints)
+    totalPoints += points.size();
+  samplePoints.reserve(totalPoints < size_t(numPoints) + 1 ? totalPoints : size_t(numPoints) + 1);
+
+  // commit tiles in a fixed order
+  for (const auto& points : tilePoints) {
+    for (const Point& p : points) {
+      if (samplePoints.size() > numPoints)
+        return samplePoints;
+      samplePoints.push_back(p);
+    }
+  }
+
+  return samplePoints;
+}
+
+// everything that pins down the output of generatePoissonPointsParallel() bit-exactly;
+// fixed-size POD with no padding, safe to hash into content-addressed cache keys
+struct ReplayToken {
+  char version[24] = {}; // PoissonGenerator::Version the point set was generated with
+  uint32_t seed = 0;
+  uint32_t numPoints = 0;
+  uint32_t newPointsCount = 30;
+  float minDist = -1.0f;
+  uint32_t isCircle = 1;
+};
+
+// capture a token from the same PRNG state that is about to be passed to
+// generatePoissonPointsParallel() with the same parameters
+template<typename PRNG = DefaultPRNG>
+ReplayToken makeReplayToken(uint32_t numPoints, const PRNG& generator, bool isCircle = true, uint32_t newPointsCount = 30, float minDist = -1.0f) {
+  ReplayToken token;
+  strncpy(token.version, Version, sizeof(token.version) - 1);
+  token.seed = generator.getSeed();
+  token.numPoints = numPoints;
+  token.newPointsCount = newPointsCount;
+  token.minDist = minDist;
+  token.isCircle = isCircle ? 1 : 0;
+  return token;
+}
+
+/**
+   Reproduce the exact point set a token was captured for. The parallel engine is
+   bit-identical across runs, machines and thread counts (per-tile PRNG streams derived
+   from the seed, a thread-count-independent tile layout and a fixed tile commit order;
+   a single-thread request is floored at 2 so the tiled engine is always the one that
+   runs) - but not across library versions, so a token carrying a different Version
+   returns an empty vector and the caller has to regenerate and re-cache
+**/
+template<typename PRNG = DefaultPRNG>
+std::vector<Point> replayPoissonPoints(const ReplayToken& token, uint32_t numThreads) {
+  if (strncmp(token.version, Version, sizeof(token.version)) != 0)
+    return std::vector<Point>();
+
+  // generatePoissonPointsParallel() falls back to the serial engine for a single
+  // thread, which produces a different (equally valid) set - floor at 2 so a token
+  // replays bit-identically on single-core machines as well
+  if (numThreads < 2)
+    numThreads = 2;
+
+  PRNG generator(token.seed);
+  return generatePoissonPointsParallel(token.numPoints, generator, numThreads, token.isCircle != 0, token.newPointsCount, token.minDist);
+}
+
+/**
+   Windowed generation for out-of-core worlds: sample only the [windowMin..windowMax]
+   rectangle (any coordinate range - the window does not have to lie in the unit square),
+   seeded with 'boundaryPoints' from previously generated neighbouring windows so the
+   minimum-distance property holds across window edges; boundary points within one scan
+   reach also act as parents, so the window fills tightly against its borders. The grid
+   covers just the window plus that margin, keeping cost and peak memory O(edit) instead
+   of O(world)
+**/
+template<typename PRNG = DefaultPRNG>
+std::vector<Point> generatePoissonPointsWindow(const Point& windowMin,
+                                               const Point& windowMax,
+                                               const std::vector<Point>& boundaryPoints,
+                                               PRNG& generator,
+                                               float minDist,
+                                               uint32_t newPointsCount = 30) {
+  std::vector<Point> samplePoints;
+
+  const float w = windowMax.x - windowMin.x;
+  const float h = windowMax.y - windowMin.y;
+  if (w <= 0.0f || h <= 0.0f || minDist <= 0.0f)
+    return samplePoints;
+
+  const float cellSize = minDist / sqrt(2.0f);
+  const float margin = float(Grid::scanCells(minDist, cellSize)) * cellSize;
+
+  // the grid spans the window plus a one-reach margin, addressed in window-local coordinates
+  const Point gridMin(windowMin.x - margin, windowMin.y - margin);
+  const int gridW = (int)ceil((w + 2.0f * margin) / cellSize);
+  const int gridH = (int)ceil((h + 2.0f * margin) / cellSize);
+
+  Grid grid(gridW, gridH, cellSize);
+
+  auto toLocal = [&gridMin](const Point& p) { return Point(p.x - gridMin.x, p.y - gridMin.y); };
+
+  std::vector<Point> processList;
+
+  // neighbouring-window points inside the margin are obstacles and parents; the rest are ignored
+  for (const Point& p : boundaryPoints) {
+    const Point lp = toLocal(p);
+    if (lp.x < 0.0f || lp.y < 0.0f || lp.x >= float(gridW) * cellSize || lp.y >= float(gridH) * cellSize)
+      continue;
+    grid.insert(lp);
+    processList.push_back(p);
+  }
+
+  // interior darts start the fill when there are no neighbours yet
+  for (uint32_t i = 0; i != newPointsCount; i++) {
+    const Point p(windowMin.x + w * generator.randomFloat(), windowMin.y + h * generator.randomFloat());
+    const Point lp = toLocal(p);
+    if (!grid.isInNeighbourhood(lp, minDist, cellSize)) {
+      grid.insert(lp);
+      samplePoints.push_back(p);
+      processList.push_back(p);
+    }
+  }
+
+  Point candidates[kCandidateBatchSize];
+
+  while (!processList.empty()) {
+    const Point point = popRandom<PRNG>(processList, generator);
+
+    for (uint32_t numLeft = newPointsCount; numLeft;) {
+      const uint32_t batch = numLeft < kCandidateBatchSize ? numLeft : kCandidateBatchSize;
+      generateRandomPointsAround(point, minDist, generator, candidates, batch);
+      numLeft -= batch;
+
+      for (uint32_t i = 0; i < batch; i++) {
+        const Point& newPoint = candidates[i];
+        if (newPoint.x < windowMin.x || newPoint.x >= windowMax.x || newPoint.y < windowMin.y || newPoint.y >= windowMax.y)
+          continue;
+
+        const Point lp = toLocal(newPoint);
+        if (!grid.isInNeighbourhood(lp, minDist, cellSize)) {
+          grid.insert(lp);
+          samplePoints.push_back(newPoint);
+          processList.push_back(newPoint);
+        }
+      }
+    }
+  }
+
+  return samplePoints;
+}
+
+/**
+   Persistent editable Poisson point set over the unit square for dynamic respawn: wraps
+   the background Grid with stable point ids, O(1) insert() / remove() and local Bridson
+   repair of the vacated areas - fillGaps() re-runs candidate generation only around
+   removed points, so patching a large set costs microseconds instead of a full
+   regeneration. Build it from any generator's output (the input is assumed to respect
+   'minDist'). Removed slots keep their id for reuse and are flagged with valid_ == false
+   in points()
+**/
+template<typename PRNG = DefaultPRNG>
+class PoissonPointSet {
+ public:
+  static const uint32_t kInvalidId = 0xffffffff;
+
+  PoissonPointSet(const std::vector<Point>& points, float minDist, const PRNG& generator = PRNG(), uint32_t newPointsCount = 30)
+      : generator_(generator)
+      , newPointsCount_(newPointsCount)
+      , minDist_(minDist)
+      , cellSize_(minDist / sqrt(2.0f))
+      , grid_((int)ceil(1.0f / cellSize_), (int)ceil(1.0f / cellSize_), cellSize_) {
+    points_.reserve(points.size());
+    for (const Point& p : points)
+      insert(p);
+  }
+
+  // try to add a point; returns its stable id, or kInvalidId when it violates minDist
+  uint32_t insert(const Point& p) {
+    if (!p.isInRectangle() || grid_.isInNeighbourhood(p, minDist_, cellSize_))
+      return kInvalidId;
+
+    grid_.insert(p);
+
+    uint32_t id;
+    if (!freeList_.empty()) {
+      id = freeList_.back();
+      freeList_.pop_back();
+      points_[id] = p;
+    } else {
+      id = uint32_t(points_.size());
+      points_.push_back(p);
+    }
+    return id;
+  }
+
+  // remove a point by id; the vacated area is remembered and refilled by the next fillGaps()
+  bool remove(uint32_t pointId) {
+    if (pointId >= points_.size() || !points_[pointId].valid_)
+      return false;
+
+    grid_.remove(points_[pointId]);
+    wounds_.push_back(points_[pointId]);
+    points_[pointId].valid_ = false;
+    freeList_.push_back(pointId);
+    return true;
+  }
+
+  // locally re-run Bridson around every pending removal inside [regionMin..regionMax];
+  // returns the number of points respawned
+  uint32_t fillGaps(const Point& regionMin, const Point& regionMax) {
+    uint32_t numAdded = 0;
+
+    std::vector<Point> processList;
+    std::vector<Point> remainingWounds;
+    for (const Point& wound : wounds_) {
+      const bool inRegion = wound.x >= regionMin.x && wound.x <= regionMax.x && wound.y >= regionMin.y && wound.y <= regionMax.y;
+      if (inRegion)
+        processList.push_back(wound);
+      else
+        remainingWounds.push_back(wound);
+    }
+    wounds_.swap(remainingWounds);
+
+    // annulus candidates around a wound cannot land inside its own vacated disc, so dart
+    // the disc directly first; accepted respawns then seed the regular candidate flood
+    const size_t numWounds = processList.size();
+    for (size_t w = 0; w != numWounds; w++) {
+      const Point wound = processList[w];
+      for (uint32_t i = 0; i != newPointsCount_; i++) {
+        const float kPi = 3.141592653589f;
+        const float r = minDist_ * sqrt(generator_.randomFloat()); // area-uniform
+        const float a = 2.0f * kPi * generator_.randomFloat() - kPi;
+        const float shifted = a + 0.5f * kPi;
+        const float cosA = fastSin(shifted > kPi ? shifted - 2.0f * kPi : shifted);
+        const Point candidate(wound.x + r * cosA, wound.y + r * fastSin(a));
+        if (insert(candidate) != kInvalidId) {
+          processList.push_back(candidate);
+          numAdded++;
+        }
+      }
+    }
+
+    Point candidates[kCandidateBatchSize];
+
+    while (!processList.empty()) {
+      const Point point = popRandom<PRNG>(processList, generator_);
+
+      for (uint32_t numLeft = newPointsCount_; numLeft;) {
+        const uint32_t batch = numLeft < kCandidateBatchSize ? numLeft : kCandidateBatchSize;
+        generateRandomPointsAround(point, minDist_, generator_, candidates, batch);
+        numLeft -= batch;
+
+        for (uint32_t i = 0; i < batch; i++) {
+          if (insert(candidates[i]) != kInvalidId) {
+            processList.push_back(candidates[i]);
+            numAdded++;
+          }
+        }
+      }
+    }
+
+    return numAdded;
+  }
+  uint32_t fillGaps() {
+    return fillGaps(Point(0.0f, 0.0f), Point(1.0f, 1.0f));
+  }
+
+  // all slots, including removed ones (valid_ == false); ids index into this vector
+  const std::vector<Point>& points() const {
+    return points_;
+  }
+  size_t numPoints() const {
+    return points_.size() - freeList_.size();
+  }
+  float minDist() const {
+    return minDist_;
+  }
+
+ private:
+  PRNG generator_;
+  uint32_t newPointsCount_;
+  float minDist_;
+  float cellSize_;
+  Grid grid_;
+  std::vector<Point> points_;
+  std::vector<uint32_t> freeList_;
+  std::vector<Point> wounds_;
+};
+
+// generation backends for generatePoissonPointsBackend()
+enum Backend {
+  Backend_Auto = 0, // parallel CPU for large requests, serial below that
+  Backend_CPU = 1,
+  Backend_CPUParallel = 2,
+  Backend_GPU = 3, // available when a POISSON_GPU_BACKEND implementation is linked in
+};
+
+#if defined(POISSON_GPU_BACKEND)
+// Offload ABI, implemented by a user-supplied CUDA/compute translation unit: phase-group
+// parallel dart throwing over the same flat grid layout and tile scheme as
+// generatePoissonPointsParallel(), writing packed XY pairs into 'outXY' and returning the
+// number of points. A given (seed, parameters) pair must produce the same point set as
+// the CPU tiles so cached bakes stay backend-independent
+uint32_t generatePoissonPointsGPU(uint32_t numPoints, uint32_t seed, float* outXY, uint32_t capacity, bool isCircle, uint32_t newPointsCount, float minDist);
+#endif // POISSON_GPU_BACKEND
+
+/**
+   Backend-dispatching generation into a caller-provided buffer (2 * capacity floats of
+   packed XY pairs); returns the number of points written. Pipelines pick the backend per
+   job size through one entry point: Backend_Auto chooses the parallel CPU path for large
+   requests, and Backend_GPU silently falls back to the parallel CPU path when no
+   POISSON_GPU_BACKEND implementation is compiled in
+**/
+template<typename PRNG = DefaultPRNG>
+uint32_t generatePoissonPointsBackend(Backend backend,
+                                      uint32_t numPoints,
+                                      PRNG& generator,
+                                      float* outXY,
+                                      uint32_t capacity,
+                                      bool isCircle = true,
+                                      uint32_t newPointsCount = 30,
+                                      float minDist = -1.0f,
+                                      uint32_t numThreads = 0) {
+  if (backend == Backend_Auto)
+    backend = numPoints >= 100000 ? Backend_CPUParallel : Backend_CPU;
+
+#if defined(POISSON_GPU_BACKEND)
+  if (backend == Backend_GPU)
+    return generatePoissonPointsGPU(numPoints, generator.getSeed(), outXY, capacity, isCircle, newPointsCount, minDist);
+#else
+  if (backend == Backend_GPU)
+    backend = Backend_CPUParallel; // no GPU implementation compiled in - fall back
+#endif // POISSON_GPU_BACKEND
+
+  if (backend == Backend_CPUParallel) {
+    const uint32_t threads = numThreads ? numThreads : std::thread::hardware_concurrency();
+    const std::vector<Point> points = generatePoissonPointsParallel(numPoints, generator, threads, isCircle, newPointsCount, minDist);
+
+    uint32_t count = 0;
+    for (const Point& p : points) {
+      if (count == capacity)
+        break;
+      outXY[2 * count + 0] = p.x;
+      outXY[2 * count + 1] = p.y;
+      count++;
+    }
+    return count;
+  }
+
+  return generatePoissonPoints(numPoints, generator, outXY, capacity, isCircle, newPointsCount, minDist);
+}
+
+/**
+   Generate exactly 'numPoints' points. The plain generatePoissonPoints() saturates a
+   doubled request and truncates - about half the generated points are thrown away. Here
+   a small pilot pass saturates first and measures the packing constant of the chosen
+   domain shape (the saturated count times minDist^2 is nearly scale-invariant), minDist
+   is tuned so the domain saturates just above the request, and the main pass terminates
+   the moment the count is met. If the tuned run still saturates short of the request,
+   minDist is tightened and the pass retried (rare - the tuning slack absorbs the
+   variance); after three attempts whatever was generated is returned
+**/
+template<typename PRNG = DefaultPRNG>
+std::vector<Point> generatePoissonPointsExact(uint32_t numPoints, PRNG& generator, bool isCircle = true, uint32_t newPointsCount = 30) {
+  std::vector<Point> points;
+
+  if (!numPoints)
+    return points;
+
+  // pilot pass: saturate a small run at the default spacing heuristic
+  const uint32_t pilotTarget = numPoints / 16 < 256 ? (numPoints < 256 ? numPoints : 256) : (numPoints / 16 > 2048 ? 2048 : numPoints / 16);
+  const float pilotMinDist = sqrt(float(2 * pilotTarget)) / float(2 * pilotTarget);
+
+  PoissonSampler<PRNG> pilot(pilotTarget * 4, generator, isCircle, newPointsCount, pilotMinDist);
+  while (!pilot.isDone())
+    pilot.step(pilotTarget);
+  generator = pilot.generator();
+
+  const float packingConstant = float(pilot.points().size()) * pilotMinDist * pilotMinDist;
+
+  // spacing at which the domain saturates at ~1.15x the request
+  float minDist = sqrt(packingConstant / (1.15f * float(numPoints)));
+
+  for (int attempt = 0; attempt != 3; attempt++) {
+    PoissonSampler<PRNG> sampler(numPoints, generator, isCircle, newPointsCount, minDist);
+
+    while (!sampler.isDone() && sampler.points().size() < numPoints)
+      sampler.step(numPoints - uint32_t(sampler.points().size()));
+
+    generator = sampler.generator();
+    points = sampler.takePoints();
+
+    if (points.size() >= numPoints) {
+      points.resize(numPoints);
+      break;
+    }
+
+    minDist *= 0.9f; // saturated below the request - tighten the spacing and retry
+  }
+
+  return points;
+}
+
+// wrap a coordinate onto the unit torus [0..1); for tiny negative x the subtraction
+// rounds 1.0f - eps up to exactly 1.0f, which imageToGrid() would map one cell past
+// the grid row - keep the result strictly below 1
+inline float wrapUnit(float x) {
+  const float w = x - floorf(x);
+  return w < 1.0f ? w : 0.0f;
+}
+
+/**
+   Return a tileable point set: the unit square is treated as a torus, candidate
+   coordinates wrap around the borders and neighbour lookups use the wrap-around
+   metric, so every point keeps minDist from every other across the seam as well.
+   Copies of the set laid side by side tile seamlessly - one set replaces per-tile
+   regeneration and the border-margin post-filter
+**/
+template<typename PRNG = DefaultPRNG>
+std::vector<Point> generatePoissonPointsTileable(uint32_t numPoints, PRNG& generator, uint32_t newPointsCount = 30, float minDist = -1.0f) {
+  // same target and spacing heuristics as the square path of the other engines
+  numPoints *= 2;
+  {
+    const double Pi_4 = 0.785398163397448309616; // PI/4
+    numPoints = static_cast<int>(Pi_4 * numPoints);
+  }
+
+  if (minDist < 0.0f) {
+    minDist = sqrt(float(numPoints)) / float(numPoints);
+  }
+
+  std::vector<Point> samplePoints;
+  std::vector<Point> processList;
+  samplePoints.reserve(size_t(numPoints) + newPointsCount);
+  processList.reserve(size_t(numPoints) + newPointsCount);
+
+  // the grid must tile the torus exactly: with cellSize = minDist/sqrt(2) the last
+  // row/column is a partial cell, so a wrapped scan window counted in cell indices
+  // spans less distance across the seam than minDist and misses close neighbours.
+  // Snap to a whole number of cells instead - cellSize <= minDist/sqrt(2) keeps the
+  // one-point-per-cell invariant
+  const int gridSize = (int)ceil(sqrt(2.0f) / minDist);
+  const float cellSize = 1.0f / float(gridSize);
+
+  Grid grid(gridSize, gridSize, cellSize);
+
+  // on the torus every position is valid
+  const Point firstPoint(generator.randomFloat(), generator.randomFloat());
+  processList.push_back(firstPoint);
+  samplePoints.push_back(firstPoint);
+  grid.insert(firstPoint);
+
+  Point candidates[kCandidateBatchSize];
+
+  while (!processList.empty() && samplePoints.size() <= numPoints) {
+    const Point point = popRandom<PRNG>(processList, generator);
+
+    for (uint32_t numLeft = newPointsCount; numLeft;) {
+      const uint32_t batch = numLeft < kCandidateBatchSize ? numLeft : kCandidateBatchSize;
+      generateRandomPointsAround(point, minDist, generator, candidates, batch);
+      numLeft -= batch;
+
+      for (uint32_t i = 0; i < batch && samplePoints.size() <= numPoints; i++) {
+        const Point newPoint(wrapUnit(candidates[i].x), wrapUnit(candidates[i].y));
+
+        if (!grid.isInNeighbourhoodWrapped(newPoint, minDist, cellSize)) {
+          processList.push_back(newPoint);
+          samplePoints.push_back(newPoint);
+          grid.insert(newPoint);
+        }
+      }
+    }
+  }
+
+  return samplePoints;
+}
+
+// one scatter layer of generateMultiClassPoissonPoints()
+struct PointClass {
+  uint32_t numPoints = 0; // target number of points of this class
+  float radius = 0.0f; // minimal distance between two points of this class
+};
+
+/**
+   Multi-class Poisson sampling: generate up to 256 point classes (trees, rocks, grass...)
+   over one shared grid instead of one generatePoissonPoints() pass per class followed by
+   an O(n*m) cross-class cleanup. 'interClassDist' is a row-major numClasses x numClasses
+   matrix: a candidate of class 'a' is rejected when an existing point of class 'b' is
+   closer than interClassDist[a * numClasses + b]; pass nullptr for the
+   (radius_a + radius_b) / 2 default - same-class spacing stays radius_a and cross-class
+   pairs meet halfway, the usual multi-class blue-noise choice (a hard
+   max(radius_a, radius_b) matrix would let a saturated early class exclude every
+   location for later smaller classes). All matrix entries must be positive: a zero
+   entry would allow arbitrarily close pairs, which the one-point-per-cell grid cannot
+   represent, so such a matrix yields empty results. Classes are sampled in the given
+   order, each class testing its candidates against all points inserted so far - place
+   the largest radii first so they are not crowded out
+**/
+template<typename PRNG = DefaultPRNG>
+std::vector<std::vector<Point>> generateMultiClassPoissonPoints(const PointClass* classes,
+                                                                uint32_t numClasses,
+                                                                const float* interClassDist,
+                                                                PRNG& generator,
+                                                                bool isCircle = true,
+                                                                uint32_t newPointsCount = 30) {
+  std::vector<std::vector<Point>> pointsByClass(numClasses);
+
+  if (!numClasses || numClasses > 256)
+    return pointsByClass;
+
+  // the full pairwise threshold matrix; its smallest entry is the closest any two
+  // accepted points can be and thus bounds the cell size, keeping the one-point-per-cell
+  // grid invariant across classes
+  std::vector<float> thresholds(size_t(numClasses) * numClasses);
+  float minThr = 1.0f;
+  for (uint32_t a = 0; a != numClasses; a++) {
+    for (uint32_t b = 0; b != numClasses; b++) {
+      const float byRadius = 0.5f * (classes[a].radius + classes[b].radius);
+      const float thr = interClassDist ? interClassDist[a * numClasses + b] : byRadius;
+      // a non-positive threshold admits coincident points of different classes; the
+      // shared grid holds one point per cell and would silently overwrite the earlier
+      // one, hiding it from all later queries - refuse the matrix instead
+      if (thr <= 0.0f)
+        return pointsByClass;
+      thresholds[a * numClasses + b] = thr;
+      if (thr < minThr)
+        minThr = thr;
+    }
+  }
+
+  const float cellSize = minThr / sqrt(2.0f);
+  const int gridSize = (int)ceil(1.0f / cellSize);
+
+  Grid grid(gridSize, gridSize, cellSize);
+
+  Point candidates[kCandidateBatchSize];
+
+  for (uint32_t c = 0; c != numClasses; c++) {
+    const float* thrRow = &thresholds[size_t(c) * numClasses];
+    const float classRadius = thrRow[c];
+
+    float reach = 0.0f;
+    for (uint32_t b = 0; b != numClasses; b++)
+      reach = thrRow[b] > reach ? thrRow[b] : reach;
+
+    std::vector<Point>& points = pointsByClass[c];
+    std::vector<Point> processList;
+    points.reserve(classes[c].numPoints);
+    processList.reserve(classes[c].numPoints);
+
+    // seed the class with dart throws - earlier classes may already occupy its best spots,
+    // so budget one dart per requested point to find the remaining gaps
+    const uint32_t numDarts = classes[c].numPoints > newPointsCount ? classes[c].numPoints : newPointsCount;
+    for (uint32_t i = 0; i != numDarts && points.size() < classes[c].numPoints; i++) {
+      const Point p(generator.randomFloat(), generator.randomFloat());
+
+      if (!(isCircle ? p.isInCircle() : p.isInRectangle()))
+        continue;
+
+      if (grid.isInNeighbourhoodMultiClass(p, thrRow, reach, cellSize))
+        continue;
+
+      processList.push_back(p);
+      points.push_back(p);
+      grid.insert(p, 0.0f, c);
+    }
+
+    while (!processList.empty() && points.size() < classes[c].numPoints) {
+      const Point point = popRandom<PRNG>(processList, generator);
+
+      for (uint32_t numLeft = newPointsCount; numLeft && points.size() < classes[c].numPoints;) {
+        const uint32_t batch = numLeft < kCandidateBatchSize ? numLeft : kCandidateBatchSize;
+        generateRandomPointsAround(point, classRadius, generator, candidates, batch);
+        numLeft -= batch;
+
+        for (uint32_t i = 0; i < batch && points.size() < classes[c].numPoints; i++) {
+          const Point& newPoint = candidates[i];
+
+          if (!(isCircle ? newPoint.isInCircle() : newPoint.isInRectangle()))
+            continue;
+
+          if (!grid.isInNeighbourhoodMultiClass(newPoint, thrRow, reach, cellSize)) {
+            processList.push_back(newPoint);
+            points.push_back(newPoint);
+            grid.insert(newPoint, 0.0f, c);
+          }
+        }
+      }
+    }
+  }
+
+  return pointsByClass;
+}
+
+/**
+   N-dimensional Bridson sampling over the unit cube [0..1]^N - the 2D types and code
+   paths above stay separate and compile exactly as before. The grid cell size is
+   minDist / sqrt(N) so a cell still holds at most one point
+**/
+template<uint32_t N>
+struct PointND {
+  float v[N] = {};
+
+  bool isInUnitCube() const {
+    for (uint32_t i = 0; i != N; i++)
+      if (v[i] < 0.0f || v[i] > 1.0f)
+        return false;
+    return true;
+  }
+  bool isInUnitBall() const {
+    float d2 = 0.0f;
+    for (uint32_t i = 0; i != N; i++) {
+      const float d = v[i] - 0.5f;
+      d2 += d * d;
+    }
+    return d2 <= 0.25f;
+  }
+};
+
+// flat N-D background grid; for N == 3 cells are addressed through 4x4x4 blocks so the
+// neighbourhood scan touches a few L1-resident blocks instead of h*w-strided rows
+template<uint32_t N>
+class GridND {
+ public:
+  GridND(int size, float cellSize) : size_(size), cellSize_(cellSize) {
+    blocksPerSide_ = (size + kBlockSide - 1) / kBlockSide;
+
+    size_t numCells = 1;
+    for (uint32_t i = 0; i != N; i++)
+      numCells *= size_t(blocksPerSide_) * kBlockSide;
+
+    cells_.resize(numCells);
+    occupied_.resize(numCells, 0);
+  }
+
+  void insert(const PointND<N>& p) {
+    int g[N];
+    cellOf(p, g);
+    const size_t idx = cellIndex(g);
+    cells_[idx] = p;
+    occupied_[idx] = 1;
+  }
+
+  bool isInNeighbourhood(const PointND<N>& point, float minDist) const {
+    int g[N], lo[N], hi[N], it[N];
+    cellOf(point, g);
+
+    const int D = (int)ceil(minDist / cellSize_);
+    for (uint32_t i = 0; i != N; i++) {
+      lo[i] = g[i] - D > 0 ? g[i] - D : 0;
+      hi[i] = g[i] + D < size_ - 1 ? g[i] + D : size_ - 1;
+      it[i] = lo[i];
+    }
+
+    // odometer walk over the [lo..hi]^N window
+    for (;;) {
+      const size_t idx = cellIndex(it);
+      if (occupied_[idx]) {
+        float d2 = 0.0f;
+        for (uint32_t i = 0; i != N; i++) {
+          const float d = cells_[idx].v[i] - point.v[i];
+          d2 += d * d;
+        }
+        if (d2 < minDist * minDist)
+          return true;
+      }
+
+      uint32_t axis = 0;
+      while (axis != N && ++it[axis] > hi[axis]) {
+        it[axis] = lo[axis];
+        axis++;
+      }
+      if (axis == N)
+        return false;
+    }
+  }
+
+ private:
+  static const int kBlockSide = 4; // 4^N cells per block
+
+  void cellOf(const PointND<N>& p, int* g) const {
+    for (uint32_t i = 0; i != N; i++) {
+      g[i] = (int)(p.v[i] / cellSize_);
+      // a coordinate of exactly 1.0 maps onto the clamped last cell
+      if (g[i] > size_ - 1)
+        g[i] = size_ - 1;
+    }
+  }
+
+  // cache-blocked addressing: cells of one kBlockSide^N block are contiguous, so a
+  // compact neighbourhood window lands in a handful of blocks
+  size_t cellIndex(const int* g) const {
+    size_t block = 0;
+    size_t local = 0;
+    for (uint32_t i = N; i--;) {
+      block = block * size_t(blocksPerSide_) + size_t(g[i] / kBlockSide);
+      local = local * kBlockSide + size_t(g[i] % kBlockSide);
+    }
+    size_t blockCells = 1;
+    for (uint32_t i = 0; i != N; i++)
+      blockCells *= kBlockSide;
+    return block * blockCells + local;
+  }
+
+ private:
+  int size_;
+  int blocksPerSide_;
+  float cellSize_;
+  std::vector<PointND<N>> cells_;
+  std::vector<uint8_t> occupied_;
+};
+
+// rejection-sample the [minDist..2*minDist] spherical annulus around 'p'
+template<uint32_t N, typename PRNG>
+PointND<N> generateRandomPointAroundND(const PointND<N>& p, float minDist, PRNG& generator) {
+  for (;;) {
+    float off[N];
+    float d2 = 0.0f;
+    for (uint32_t i = 0; i != N; i++) {
+      off[i] = (2.0f * generator.randomFloat() - 1.0f) * 2.0f * minDist;
+      d2 += off[i] * off[i];
+    }
+    if (d2 >= minDist * minDist && d2 <= 4.0f * minDist * minDist) {
+      PointND<N> newPoint;
+      for (uint32_t i = 0; i != N; i++)
+        newPoint.v[i] = p.v[i] + off[i];
+      return newPoint;
+    }
+  }
+}
+
+/**
+   Return a vector of N-D points sampled over the unit cube (or the inscribed ball when
+   'isBall' is set); generatePoissonPointsND<3> replaces stacking 2D layers for
+   volumetric scatter. The default minDist generalizes the 2D heuristic to
+   numPoints^(-1/N)
+**/
+template<uint32_t N, typename PRNG = DefaultPRNG>
+std::vector<PointND<N>> generatePoissonPointsND(uint32_t numPoints,
+                                                PRNG& generator,
+                                                bool isBall = false,
+                                                uint32_t newPointsCount = 30,
+                                                float minDist = -1.0f) {
+  if (numPoints < 1)
+    numPoints = 1;
+
+  if (minDist < 0.0f) {
+    // same heuristic as the 2D default: estimate the spacing for twice the requested
+    // count, so the process saturates at roughly 'numPoints' accepted points
+    minDist = powf(2.0f * float(numPoints), -1.0f / float(N));
+  }
+
+  std::vector<PointND<N>> samplePoints;
+  std::vector<PointND<N>> processList;
+  samplePoints.reserve(size_t(numPoints) + newPointsCount);
+  processList.reserve(size_t(numPoints) + newPointsCount);
+
+  const float cellSize = minDist / sqrt(float(N));
+
+  GridND<N> grid((int)ceil(1.0f / cellSize), cellSize);
+
+  PointND<N> firstPoint;
+  do {
+    for (uint32_t i = 0; i != N; i++)
+      firstPoint.v[i] = generator.randomFloat();
+  } while (isBall && !firstPoint.isInUnitBall());
+
+  processList.push_back(firstPoint);
+  samplePoints.push_back(firstPoint);
+  grid.insert(firstPoint);
+
+  while (!processList.empty() && samplePoints.size() <= numPoints) {
+    const int idx = generator.randomInt(static_cast<int>(processList.size()) - 1);
+    const PointND<N> point = processList[idx];
+    processList[idx] = processList.back();
+    processList.pop_back();
+
+    for (uint32_t i = 0; i < newPointsCount; i++) {
+      const PointND<N> newPoint = generateRandomPointAroundND(point, minDist, generator);
+      const bool canFitPoint = isBall ? newPoint.isInUnitBall() : newPoint.isInUnitCube();
+
+      if (!canFitPoint)
+        continue;
+
+      if (!grid.isInNeighbourhood(newPoint, minDist)) {
+        processList.push_back(newPoint);
+        samplePoints.push_back(newPoint);
+        grid.insert(newPoint);
+        if (samplePoints.size() > numPoints)
+          break;
+      }
+    }
+  }
+
+  return samplePoints;
+}
+
+/**
+   Reorder points in place so that every prefix of the vector is approximately
+   blue-noise distributed (progressive/hierarchical ordering): rounds of greedy
+   selection with a halving radius - points at least minDist away from everything
+   selected so far are appended, then minDist halves and the pass repeats over the
+   remainder until all points are placed. Applied to generateHammersleyPoints() or
+   generateVogelPoints() output this is an O(n) "good enough" substitute for full
+   Bridson sampling in progressive renderers; the result is a permutation of the
+   input, so the full set is unchanged
+**/
+inline void reorderProgressive(std::vector<Point>& points) {
+  if (points.size() < 3)
+    return;
+
+  std::vector<Point> ordered;
+  ordered.reserve(points.size());
+
+  std::vector<Point> remaining = std::move(points);
+  std::vector<Point> next;
+
+  float minDist = 0.5f;
+
+  while (!remaining.empty()) {
+    // duplicates can never be separated - flush whatever is left in input order
+    if (minDist < 1e-4f) {
+      for (const Point& p : remaining)
+        ordered.push_back(p);
+      break;
+    }
+
+    const float cellSize = minDist / sqrt(2.0f);
+    const int gridSize = (int)ceil(1.0f / cellSize);
+
+    // points of earlier rounds are at least 2 * minDist apart and points accepted in
+    // this round at least minDist, so the one-point-per-cell grid invariant holds
+    Grid grid(gridSize, gridSize, cellSize);
+    for (const Point& p : ordered)
+      grid.insert(p);
+
+    next.clear();
+    next.reserve(remaining.size());
+
+    for (const Point& p : remaining) {
+      if (grid.isInNeighbourhood(p, minDist, cellSize)) {
+        next.push_back(p); // too close for this round - try again at a finer radius
+      } else {
+        grid.insert(p);
+        ordered.push_back(p);
+      }
+    }
+
+    remaining.swap(next);
+    minDist *= 0.5f;
+  }
+
+  points = std::move(ordered);
+}
+
+/**
+   Spatial query index over a generated point set - the same cell-bucketed flat
+   layout the sampler grid uses internally, laid out once by counting sort into
+   cell-sorted SoA planes so radiusQuery() and kNearest() touch only the cells a
+   query can reach. build() is a single O(n) pass, negligible next to generation,
+   and accepts any point vector (Poisson, Vogel, Hammersley, loaded files);
+   returned indices refer to the source vector passed to build()
+**/
+class PointQueryIndex {
+ public:
+  PointQueryIndex() = default;
+
+  // cellSize <= 0 picks a cell size targeting ~2 points per cell
+  void build(const Point* points, uint32_t numPoints, float cellSize = -1.0f) {
+    numPoints_ = numPoints;
+    if (!numPoints)
+      return;
+
+    minX_ = maxX_ = points[0].x;
+    minY_ = maxY_ = points[0].y;
+    for (uint32_t i = 1; i != numPoints; i++) {
+      minX_ = points[i].x < minX_ ? points[i].x : minX_;
+      maxX_ = points[i].x > maxX_ ? points[i].x : maxX_;
+      minY_ = points[i].y < minY_ ? points[i].y : minY_;
+      maxY_ = points[i].y > maxY_ ? points[i].y : maxY_;
+    }
+
+    const float extX = (maxX_ - minX_) > 1e-6f ? (maxX_ - minX_) : 1e-6f;
+    const float extY = (maxY_ - minY_) > 1e-6f ? (maxY_ - minY_) : 1e-6f;
+
+    cellSize_ = cellSize > 0.0f ? cellSize : sqrtf(2.0f * extX * extY / float(numPoints));
+
+    w_ = (int)ceil(extX / cellSize_);
+    h_ = (int)ceil(extY / cellSize_);
+    if (w_ < 1)
+      w_ = 1;
+    if (h_ < 1)
+      h_ = 1;
+
+    // counting sort points into cell-contiguous runs: one histogram pass, one scatter pass
+    cellStart_.assign(size_t(w_) * size_t(h_) + 1, 0);
+    for (uint32_t i = 0; i != numPoints; i++)
+      cellStart_[cellOf(points[i]) + 1]++;
+    for (size_t c = 1; c != cellStart_.size(); c++)
+      cellStart_[c] += cellStart_[c - 1];
+
+    x_.resize(numPoints);
+    y_.resize(numPoints);
+    id_.resize(numPoints);
+
+    std::vector<uint32_t> cursor(cellStart_.begin(), cellStart_.end() - 1);
+    for (uint32_t i = 0; i != numPoints; i++) {
+      const uint32_t pos = cursor[cellOf(points[i])]++;
+      x_[pos] = points[i].x;
+      y_[pos] = points[i].y;
+      id_[pos] = i;
+    }
+  }
+  void build(const std::vector<Point>& points, float cellSize = -1.0f) { build(points.data(), uint32_t(points.size()), cellSize); }
+
+  // append the indices of all points within 'radius' of 'center' to 'result'
+  void radiusQuery(const Point& center, float radius, std::vector<uint32_t>& result) const {
+    if (!numPoints_)
+      return;
+
+    const float r2 = radius * radius;
+
+    const int x0 = clampCellX(center.x - radius);
+    const int x1 = clampCellX(center.x + radius);
+    const int y0 = clampCellY(center.y - radius);
+    const int y1 = clampCellY(center.y + radius);
+
+    for (int j = y0; j <= y1; j++) {
+      for (int i = x0; i <= x1; i++) {
+        const size_t cell = size_t(i) + size_t(j) * size_t(w_);
+        for (uint32_t s = cellStart_[cell]; s != cellStart_[cell + 1]; s++) {
+          const float dx = x_[s] - center.x;
+          const float dy = y_[s] - center.y;
+          if (dx * dx + dy * dy <= r2)
+            result.push_back(id_[s]);
+        }
+      }
+    }
+  }
+
+  // the (at most) 'k' points nearest to 'center', ordered nearest first
+  void kNearest(const Point& center, uint32_t k, std::vector<uint32_t>& result) const {
+    result.clear();
+    if (!numPoints_ || !k)
+      return;
+
+    std::vector<std::pair<float, uint32_t>> best;
+
+    const int ci = clampCellX(center.x);
+    const int cj = clampCellY(center.y);
+    const int maxD = w_ > h_ ? w_ : h_;
+
+    // grow the scanned square ring by ring; stop once no unscanned cell can beat the k-th best
+    for (int D = 0; D <= maxD; D++) {
+      for (int j = cj - D; j <= cj + D; j++) {
+        if (j < 0 || j >= h_)
+          continue;
+        const int stride = (j == cj - D || j == cj + D) ? 1 : 2 * D;
+        for (int i = ci - D; i <= ci + D; i += stride) {
+          if (i < 0 || i >= w_)
+            continue;
+          const size_t cell = size_t(i) + size_t(j) * size_t(w_);
+          for (uint32_t s = cellStart_[cell]; s != cellStart_[cell + 1]; s++) {
+            const float dx = x_[s] - center.x;
+            const float dy = y_[s] - center.y;
+            best.push_back(std::make_pair(dx * dx + dy * dy, id_[s]));
+          }
+        }
+      }
+
+      if (best.size() >= k) {
+        std::nth_element(best.begin(), best.begin() + (k - 1), best.end());
+        // world-space distance from center to the nearest unscanned cell of the window
+        const float wx0 = center.x - (minX_ + float(ci - D) * cellSize_);
+        const float wx1 = (minX_ + float(ci + D + 1) * cellSize_) - center.x;
+        const float wy0 = center.y - (minY_ + float(cj - D) * cellSize_);
+        const float wy1 = (minY_ + float(cj + D + 1) * cellSize_) - center.y;
+        float guard = wx0 < wx1 ? wx0 : wx1;
+        guard = wy0 < guard ? wy0 : guard;
+        guard = wy1 < guard ? wy1 : guard;
+        if (guard > 0.0f && best[k - 1].first <= guard * guard)
+          break;
+      }
+
+      if (ci - D <= 0 && cj - D <= 0 && ci + D >= w_ - 1 && cj + D >= h_ - 1)
+        break;
+    }
+
+    if (best.size() > k)
+      best.resize(k);
+    std::sort(best.begin(), best.end());
+
+    result.reserve(best.size());
+    for (const auto& b : best)
+      result.push_back(b.second);
+  }
+
+  uint32_t numPoints() const { return numPoints_; }
+
+ private:
+  int clampCellX(float x) const {
+    const int i = (int)((x - minX_) / cellSize_);
+    return i < 0 ? 0 : (i >= w_ ? w_ - 1 : i);
+  }
+  int clampCellY(float y) const {
+    const int j = (int)((y - minY_) / cellSize_);
+    return j < 0 ? 0 : (j >= h_ ? h_ - 1 : j);
+  }
+  size_t cellOf(const Point& p) const { return size_t(clampCellX(p.x)) + size_t(clampCellY(p.y)) * size_t(w_); }
+
+ private:
+  uint32_t numPoints_ = 0;
+  int w_ = 0;
+  int h_ = 0;
+  float cellSize_ = 0;
+  float minX_ = 0;
+  float minY_ = 0;
+  float maxX_ = 0;
+  float maxY_ = 0;
+  std::vector<uint32_t> cellStart_; // w_ * h_ + 1 prefix sums into the planes below
+  std::vector<float> x_; // cell-sorted point coordinates
+  std::vector<float> y_;
+  std::vector<uint32_t> id_; // index of each cell-sorted slot in the source vector
+};
+
+/**
+   generatePoissonPoints() plus a ready-to-use query index over the result - the
+   spatial structure is essentially free at generation time, while rebuilding a
+   k-d tree downstream can cost more than the generation itself for large sets
+**/
+template<typename PRNG = DefaultPRNG>
+std::vector<Point> generatePoissonPointsIndexed(uint32_t numPoints,
+                                                PRNG& generator,
+                                                PointQueryIndex& outIndex,
+                                                bool isCircle = true,
+                                                uint32_t newPointsCount = 30,
+                                                float minDist = -1.0f,
+                                                const DensityMap& densityMap = DensityMap()) {
+  std::vector<Point> points = generatePoissonPoints(numPoints, generator, isCircle, newPointsCount, minDist, densityMap);
+
+  outIndex.build(points);
+
+  return points;
+}
+
+/**
+   In-place repulsion relaxation - an approximate centroidal (Lloyd) step without
+   the Voronoi diagram. Each iteration rebuilds the cell index over the current
+   positions and pushes every point away from its neighbours within twice the mean
+   spacing, weighted by overlap depth; the points drift towards the centroids of
+   their empty regions, which flattens the radial power spectrum of the set (the
+   property dithering masks care about). Every iteration reads one immutable
+   snapshot and writes the next, parallelized over point ranges, so the result is
+   deterministic for any thread count. Relaxed points stay inside the sampled
+   domain: the unit circle for 'isCircle', the unit square otherwise
+**/
+inline void relaxPoints(std::vector<Point>& points, uint32_t numIterations = 3, bool isCircle = true, uint32_t numThreads = 0) {
+  if (points.size() < 2 || !numIterations)
+    return;
+
+  if (!numThreads)
+    numThreads = std::thread::hardware_concurrency();
+  if (!numThreads)
+    numThreads = 1;
+
+  // twice the mean spacing - covers the ring of natural neighbours without
+  // gathering half the set per point
+  const float reach = 2.0f * sqrt(float(points.size())) / float(points.size());
+
+  std::vector<Point> next(points.size());
+
+  PointQueryIndex index;
+
+  for (uint32_t iter = 0; iter != numIterations; iter++) {
+    index.build(points);
+
+    auto relaxRange = [&points, &next, &index, reach, isCircle](size_t rangeBegin, size_t rangeEnd) {
+      std::vector<uint32_t> neighbours;
+      for (size_t i = rangeBegin; i != rangeEnd; i++) {
+        const Point p = points[i];
+
+        neighbours.clear();
+        index.radiusQuery(p, reach, neighbours);
+
+        float pushX = 0;
+        float pushY = 0;
+        uint32_t numNeighbours = 0;
+
+        for (const uint32_t q : neighbours) {
+          if (q == i)
+            continue;
+          const float dx = p.x - points[q].x;
+          const float dy = p.y - points[q].y;
+          const float dist = sqrtf(dx * dx + dy * dy);
+          if (dist < 1e-8f) {
+            // coincident points - separate them deterministically by index order
+            pushX += (q < i) ? reach : -reach;
+            numNeighbours++;
+            continue;
+          }
+          // unit direction away from the neighbour, scaled by overlap depth
+          const float w = (reach - dist) / dist;
+          pushX += dx * w;
+          pushY += dy * w;
+          numNeighbours++;
+        }
+
+        Point moved = p;
+
+        if (numNeighbours) {
+          moved.x += 0.5f * pushX / float(numNeighbours);
+          moved.y += 0.5f * pushY / float(numNeighbours);
+        }
+
+        if (isCircle) {
+          // project escapees back onto the domain circle
+          const float cx = moved.x - 0.5f;
+          const float cy = moved.y - 0.5f;
+          const float r = sqrtf(cx * cx + cy * cy);
+          if (r > 0.5f) {
+            moved.x = 0.5f + 0.5f * cx / r;
+            moved.y = 0.5f + 0.5f * cy / r;
+          }
+        } else {
+          moved.x = moved.x < 0.0f ? 0.0f : (moved.x > 1.0f ? 1.0f : moved.x);
+          moved.y = moved.y < 0.0f ? 0.0f : (moved.y > 1.0f ? 1.0f : moved.y);
+        }
+
+        next[i] = moved;
+      }
+    };
+
+    const size_t poolSize = size_t(numThreads) < points.size() ? numThreads : 1;
+
+    if (poolSize <= 1) {
+      relaxRange(0, points.size());
+    } else {
+      std::vector<std::thread> pool;
+      pool.reserve(poolSize);
+      const size_t chunk = (points.size() + poolSize - 1) / poolSize;
+      for (size_t t = 0; t != poolSize; t++) {
+        const size_t rangeBegin = t * chunk;
+        const size_t rangeEnd = rangeBegin + chunk < points.size() ? rangeBegin + chunk : points.size();
+        pool.emplace_back(relaxRange, rangeBegin, rangeEnd);
+      }
+      for (auto& thread : pool)
+        thread.join();
+    }
+
+    points.swap(next);
+  }
+}
+
+/**
+   generatePoissonPoints() followed by relaxPoints() on the still-resident vector -
+   replaces the external single-threaded Lloyd tool and its serialize/deserialize
+   round trip for dithering-mask pipelines
+**/
+template<typename PRNG = DefaultPRNG>
+std::vector<Point> generatePoissonPointsRelaxed(uint32_t numPoints,
+                                                PRNG& generator,
+                                                uint32_t numRelaxIterations = 3,
+                                                bool isCircle = true,
+                                                uint32_t newPointsCount = 30,
+                                                float minDist = -1.0f,
+                                                uint32_t numThreads = 0) {
+  std::vector<Point> points = generatePoissonPoints(numPoints, generator, isCircle, newPointsCount, minDist);
+
+  relaxPoints(points, numRelaxIterations, isCircle, numThreads);
+
+  return points;
+}
+
+Point sampleVogelDisk(uint32_t idx, uint32_t numPoints, float phi) {
+  const float kGoldenAngle = 2.4f;
+  const float kPi = 3.141592653589f;
+
+  const float r = sqrtf(float(idx) + 0.5f) / sqrtf(float(numPoints));
+  const float theta = float(idx) * kGoldenAngle + phi;
+
+  // the fastSin polynomial needs [-pi, pi]; lrintf() rounds to nearest like
+  // _mm_cvtps_epi32() in the SSE2 kernel, keeping both paths bit-identical
+  const float reduced = theta - float(lrintf(theta * (0.5f / kPi))) * (2.0f * kPi);
+
+  // cos(a) = sin(a + pi/2), wrapped back into [-pi, pi]
+  const float shifted = reduced + 0.5f * kPi;
+  const float cosTheta = fastSin(shifted > kPi ? shifted - 2.0f * kPi : shifted);
+
+  return Point(r * cosTheta, r * fastSin(reduced));
+}
+
+namespace {
+
+#if POISSON_SIMD_SSE2
+
+// 4-lane fastSin(): the same polynomial, term for term, in SSE2 registers
+inline __m128 fastSin4(__m128 x) {
+  const float kPi = 3.141592653589f;
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  const __m128 y = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(4.0f / kPi), x),
+                              _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(4.0f / (kPi * kPi)), x), _mm_and_ps(x, absMask)));
+  return _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.225f), _mm_sub_ps(_mm_mul_ps(y, _mm_and_ps(y, absMask)), y)), y);
+}
+
+// 4-lane sampleVogelDisk(): sqrt, range reduction and sincos all stay in registers.
+// Every lane evaluates exactly the scalar arithmetic, so the vector body and the
+// scalar tail of a run produce identical floats
+inline void sampleVogelDisk4(uint32_t idx, uint32_t numPoints, float phi, float* outX, float* outY) {
+  const float kGoldenAngle = 2.4f;
+  const float kPi = 3.141592653589f;
+
+  const __m128 vPi = _mm_set1_ps(kPi);
+  const __m128 vTwoPi = _mm_set1_ps(2.0f * kPi);
+
+  const __m128 vIdx = _mm_cvtepi32_ps(_mm_setr_epi32(int(idx), int(idx + 1), int(idx + 2), int(idx + 3)));
+
+  const __m128 r =
+      _mm_div_ps(_mm_sqrt_ps(_mm_add_ps(vIdx, _mm_set1_ps(0.5f))), _mm_sqrt_ps(_mm_set1_ps(float(numPoints))));
+
+  const __m128 theta = _mm_add_ps(_mm_mul_ps(vIdx, _mm_set1_ps(kGoldenAngle)), _mm_set1_ps(phi));
+  const __m128 k = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(theta, _mm_set1_ps(0.5f / kPi))));
+  const __m128 reduced = _mm_sub_ps(theta, _mm_mul_ps(k, vTwoPi));
+
+  __m128 shifted = _mm_add_ps(reduced, _mm_set1_ps(0.5f * kPi));
+  shifted = _mm_sub_ps(shifted, _mm_and_ps(_mm_cmpgt_ps(shifted, vPi), vTwoPi));
+
+  _mm_storeu_ps(outX, _mm_mul_ps(r, fastSin4(shifted)));
+  _mm_storeu_ps(outY, _mm_mul_ps(r, fastSin4(reduced)));
+}
+
+#endif // POISSON_SIMD_SSE2
+
+} // namespace
+
+// emit Vogel disk points into any output sink
+template<typename OUTPUT>
+void generateVogelPointsInto(uint32_t numPoints, OUTPUT& output, bool isCircle = true, float phi = 0.0f, Point center = Point(0.5f, 0.5f)) {
+  const uint32_t numSamples = isCircle ? 4 * numPoints : numPoints;
+  const float phiRad = phi * 3.141592653f / 180.0f;
+
+  uint32_t i = 0;
+
+#if POISSON_SIMD_SSE2
+  float xs[4];
+  float ys[4];
+  for (; i + 4 <= numPoints; i += 4) {
+    sampleVogelDisk4(i, numSamples, phiRad, xs, ys);
+    for (int lane = 0; lane != 4; lane++)
+      output(xs[lane] + center.x, ys[lane] + center.y);
+  }
+#endif // POISSON_SIMD_SSE2
+
+  for (; i != numPoints; i++) {
+    const Point p = sampleVogelDisk(i, numSamples, phiRad) + center;
+    output(p.x, p.y);
+  }
+}
+
+/**
+   Return a vector of generated points
+**/
+std::vector<Point> generateVogelPoints(uint32_t numPoints, bool isCircle = true, float phi = 0.0f, Point center = Point(0.5f, 0.5f)) {
+  std::vector<Point> samplePoints;
+
+  samplePoints.reserve(numPoints);
+
+  OutputVector output = {&samplePoints};
+  generateVogelPointsInto(numPoints, output, isCircle, phi, center);
+
+  return samplePoints;
+}
+
+/**
+   Same, but writing packed x,y pairs into a caller-provided buffer (2 * capacity floats).
+   Returns the number of points written
+**/
+uint32_t generateVogelPoints(uint32_t numPoints, float* outXY, uint32_t capacity, bool isCircle = true, float phi = 0.0f, Point center = Point(0.5f, 0.5f)) {
+  OutputBufferXY output = {outXY, capacity, 0};
+  generateVogelPointsInto(numPoints, output, isCircle, phi, center);
+  return output.count;
+}
+
+/**
+   Same, but writing into separate caller-provided SoA x[] / y[] planes (capacity floats each).
+   Returns the number of points written
+**/
+uint32_t generateVogelPoints(uint32_t numPoints, float* outX, float* outY, uint32_t capacity, bool isCircle = true, float phi = 0.0f, Point center = Point(0.5f, 0.5f)) {
+  OutputBufferSoA output = {outX, outY, capacity, 0};
+  generateVogelPointsInto(numPoints, output, isCircle, phi, center);
+  return output.count;
+}
+
+// emit jittered grid points into any output sink
+template<typename PRNG, typename OUTPUT>
+void generateJitteredGridPointsInto(uint32_t numPoints,
+                                    PRNG& generator,
+                                    OUTPUT& output,
+                                    bool isCircle = false,
+                                    float jitterRadius = 0.004f,
+                                    Point center = Point(0.5f, 0.5f)) {
+  const uint32_t gridSize = uint32_t(sqrt(numPoints));
+
+  for (uint32_t x = 0; x != gridSize; x++) {
+    for (uint32_t y = 0; y != gridSize; y++) {
+      Point p;
+      do {
+        const Point offs = generateRandomPointAround(Point(0, 0), jitterRadius, generator) - center + Point(0.5f, 0.5f);
+        p = Point(float(x) / gridSize, float(y) / gridSize) + offs;
+        // generate a new point until it is within the boundaries
+      } while (!p.isInRectangle());
+
+      if (isCircle)
+        if (!p.isInCircle())
+          continue;
+
+      output(p.x, p.y);
+    }
+  }
+}
+
+/**
+   Return a vector of generated points
+**/
+template<typename PRNG = DefaultPRNG>
+std::vector<Point> generateJitteredGridPoints(uint32_t numPoints,
+                                              PRNG& generator,
+                                              bool isCircle = false,
+                                              float jitterRadius = 0.004f,
+                                              Point center = Point(0.5f, 0.5f)) {
+  std::vector<Point> samplePoints;
+
+  samplePoints.reserve(numPoints);
+
+  OutputVector output = {&samplePoints};
+  generateJitteredGridPointsInto(numPoints, generator, output, isCircle, jitterRadius, center);
+
+  return samplePoints;
+}
+
+/**
+   Same, but writing packed x,y pairs into a caller-provided buffer (2 * capacity floats).
+   Returns the number of points written
+**/
+template<typename PRNG = DefaultPRNG>
+uint32_t generateJitteredGridPoints(uint32_t numPoints,
+                                    PRNG& generator,
+                                    float* outXY,
+                                    uint32_t capacity,
+                                    bool isCircle = false,
+                                    float jitterRadius = 0.004f,
+                                    Point center = Point(0.5f, 0.5f)) {
+  OutputBufferXY output = {outXY, capacity, 0};
+  generateJitteredGridPointsInto(numPoints, generator, output, isCircle, jitterRadius, center);
+  return output.count;
+}
+
+/**
+   Same, but writing into separate caller-provided SoA x[] / y[] planes (capacity floats each).
+   Returns the number of points written
+**/
+template<typename PRNG = DefaultPRNG>
+uint32_t generateJitteredGridPoints(uint32_t numPoints,
+                                    PRNG& generator,
+                                    float* outX,
+                                    float* outY,
+                                    uint32_t capacity,
+                                    bool isCircle = false,
+                                    float jitterRadius = 0.004f,
+                                    Point center = Point(0.5f, 0.5f)) {
+  OutputBufferSoA output = {outX, outY, capacity, 0};
+  generateJitteredGridPointsInto(numPoints, generator, output, isCircle, jitterRadius, center);
+  return output.count;
+}
+
+// emit exactly 'numPoints' jittered grid points into any output sink, rejection-free
+template<typename PRNG, typename OUTPUT>
+void generateJitteredGridPointsExactInto(uint32_t numPoints,
+                                         PRNG& generator,
+                                         OUTPUT& output,
+                                         float jitterRadius = 0.004f,
+                                         Point center = Point(0.5f, 0.5f)) {
+  if (!numPoints)
+    return;
+
+  // smallest grid covering the request; non-square counts leave numCells - numPoints
+  // cells unused, spread evenly over the grid by the index mapping below
+  const uint32_t gridW = uint32_t(ceil(sqrt(double(numPoints))));
+  const uint32_t gridH = (numPoints + gridW - 1) / gridW;
+  const uint64_t numCells = uint64_t(gridW) * uint64_t(gridH);
+
+  for (uint32_t i = 0; i != numPoints; i++) {
+    const uint64_t cell = uint64_t(i) * numCells / numPoints;
+    const uint32_t cx = uint32_t(cell % gridW);
+    const uint32_t cy = uint32_t(cell / gridW);
+
+    // one draw pair per cell, fixed cost - no retry loop
+    const Point offs = generateRandomPointAround(Point(0, 0), jitterRadius, generator) - center + Point(0.5f, 0.5f);
+
+    Point p = Point((float(cx) + 0.5f) / float(gridW), (float(cy) + 0.5f) / float(gridH)) + offs;
+
+    // fold escapees back into the unit square analytically: reflect at the border,
+    // then clamp as a guard against pathological jitterRadius/center arguments
+    p.x = p.x < 0.0f ? -p.x : p.x;
+    p.x = p.x > 1.0f ? 2.0f - p.x : p.x;
+    p.x = p.x < 0.0f ? 0.0f : p.x;
+    p.y = p.y < 0.0f ? -p.y : p.y;
+    p.y = p.y > 1.0f ? 2.0f - p.y : p.y;
+    p.y = p.y < 0.0f ? 0.0f : p.y;
+
+    output(p.x, p.y);
+  }
+}
+
+/**
+   Rejection-free generateJitteredGridPoints(): every cell produces its point in one
+   shot (the jitter is reflected back into the unit square instead of re-rolled), a
+   non-square 'numPoints' spreads the unused cells evenly, and exactly 'numPoints'
+   points come back - no over-requesting and trimming. The per-point cost is fixed,
+   which matters when this is called thousands of times per frame batch. Covers the
+   unit square only; dice the output against a mask for other shapes
+**/
+template<typename PRNG = DefaultPRNG>
+std::vector<Point> generateJitteredGridPointsExact(uint32_t numPoints,
+                                                   PRNG& generator,
+                                                   float jitterRadius = 0.004f,
+                                                   Point center = Point(0.5f, 0.5f)) {
+  std::vector<Point> samplePoints;
+
+  samplePoints.reserve(numPoints);
+
+  OutputVector output = {&samplePoints};
+  generateJitteredGridPointsExactInto(numPoints, generator, output, jitterRadius, center);
+
+  return samplePoints;
+}
+
+/**
+   Same, but writing packed x,y pairs into a caller-provided buffer (2 * capacity floats).
+   Returns the number of points written
+**/
+template<typename PRNG = DefaultPRNG>
+uint32_t generateJitteredGridPointsExact(uint32_t numPoints,
+                                         PRNG& generator,
+                                         float* outXY,
+                                         uint32_t capacity,
+                                         float jitterRadius = 0.004f,
+                                         Point center = Point(0.5f, 0.5f)) {
+  OutputBufferXY output = {outXY, capacity, 0};
+  generateJitteredGridPointsExactInto(numPoints, generator, output, jitterRadius, center);
+  return output.count;
+}
+
+/**
+   Same, but writing into separate caller-provided SoA x[] / y[] planes (capacity floats each).
+   Returns the number of points written
+**/
+template<typename PRNG = DefaultPRNG>
+uint32_t generateJitteredGridPointsExact(uint32_t numPoints,
+                                         PRNG& generator,
+                                         float* outX,
+                                         float* outY,
+                                         uint32_t capacity,
+                                         float jitterRadius = 0.004f,
+                                         Point center = Point(0.5f, 0.5f)) {
+  OutputBufferSoA output = {outX, outY, capacity, 0};
+  generateJitteredGridPointsExactInto(numPoints, generator, output, jitterRadius, center);
+  return output.count;
+}
+
+namespace {
+
+// http://holger.dammertz.org/stuff/notes_HammersleyOnHemisphere.html
+float radicalInverse_VdC(uint32_t bits) {
+  bits = (bits << 16u) | (bits >> 16u);
+  bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+  bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+  bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+  bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+  return float(float(bits) * 2.3283064365386963e-10); // / 0x100000000
+}
+
+Point hammersley2d(uint32_t i, uint32_t N) {
+  return Point(float(i) / float(N), radicalInverse_VdC(i));
+}
+
+#if POISSON_SIMD_SSE2
+
+// 4-lane radicalInverse_VdC(): the same shift/mask reversal ladder on whole registers
+inline void radicalInverse_VdC4(uint32_t i, uint32_t* outBits) {
+  __m128i bits = _mm_setr_epi32(int(i), int(i + 1), int(i + 2), int(i + 3));
+  bits = _mm_or_si128(_mm_slli_epi32(bits, 16), _mm_srli_epi32(bits, 16));
+  bits = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x55555555)), 1),
+                      _mm_srli_epi32(_mm_and_si128(bits, _mm_set1_epi32(int(0xAAAAAAAAu))), 1));
+  bits = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x33333333)), 2),
+                      _mm_srli_epi32(_mm_and_si128(bits, _mm_set1_epi32(int(0xCCCCCCCCu))), 2));
+  bits = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x0F0F0F0F)), 4),
+                      _mm_srli_epi32(_mm_and_si128(bits, _mm_set1_epi32(int(0xF0F0F0F0u))), 4));
+  bits = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x00FF00FF)), 8),
+                      _mm_srli_epi32(_mm_and_si128(bits, _mm_set1_epi32(int(0xFF00FF00u))), 8));
+  _mm_storeu_si128((__m128i*)outBits, bits);
+}
+
+#endif // POISSON_SIMD_SSE2
+
+} // namespace
+
+// emit Hammersley points into any output sink
+template<typename OUTPUT>
+void generateHammersleyPointsInto(uint32_t numPoints, OUTPUT& output) {
+  uint32_t i = 0;
+
+#if POISSON_SIMD_SSE2
+  // the bit-twiddling ladder dominates this loop - reverse 4 indices per iteration;
+  // the cheap uint-to-float remap stays scalar so the output is bit-identical to
+  // radicalInverse_VdC()
+  uint32_t bits[4];
+  for (; i + 4 <= numPoints; i += 4) {
+    radicalInverse_VdC4(i, bits);
+    for (uint32_t lane = 0; lane != 4; lane++)
+      output(float(i + lane) / float(numPoints), float(float(bits[lane]) * 2.3283064365386963e-10));
+  }
+#endif // POISSON_SIMD_SSE2
+
+  for (; i != numPoints; i++) {
+    const Point p = hammersley2d(i, numPoints);
+
+    output(p.x, p.y);
+  }
+}
+
+/**
+   Return a vector of generated points
+**/
+std::vector<Point> generateHammersleyPoints(uint32_t numPoints) {
+  std::vector<Point> samplePoints;
+
+  samplePoints.reserve(numPoints);
+
+  OutputVector output = {&samplePoints};
+  generateHammersleyPointsInto(numPoints, output);
+
+  return samplePoints;
+}
+
+/**
+   Same, but writing packed x,y pairs into a caller-provided buffer (2 * capacity floats).
+   Returns the number of points written
+**/
+uint32_t generateHammersleyPoints(uint32_t numPoints, float* outXY, uint32_t capacity) {
+  OutputBufferXY output = {outXY, capacity, 0};
+  generateHammersleyPointsInto(numPoints, output);
+  return output.count;
+}
+
+/**
+   Same, but writing into separate caller-provided SoA x[] / y[] planes (capacity floats each).
+   Returns the number of points written
+**/
+uint32_t generateHammersleyPoints(uint32_t numPoints, float* outX, float* outY, uint32_t capacity) {
+  OutputBufferSoA output = {outX, outY, capacity, 0};
+  generateHammersleyPointsInto(numPoints, output);
+  return output.count;
+}
+
+const uint32_t kPointsFileMagic = 0x53494F50; // 'POIS'
+const uint32_t kPointsFileVersion = 1;
+
+// on-disk layout of a binary points file: this header followed by numPoints tightly packed XY float pairs
+struct PointsFileHeader {
+  uint32_t magic = kPointsFileMagic;
+  uint32_t version = kPointsFileVersion;
+  uint32_t flags = 0; // reserved
+  uint32_t numPoints = 0;
+};
+
+/**
+   Write points as a binary file: PointsFileHeader followed by a packed XY float payload.
+   Points are staged through a fixed chunk, so dumping millions of points costs a
+   handful of buffered fwrite() calls instead of a formatted (and flushed) line per point
+**/
+inline bool savePointsBinary(const char* fileName, const Point* points, uint32_t numPoints, uint32_t flags = 0) {
+  FILE* file = fopen(fileName, "wb");
+
+  if (!file)
+    return false;
+
+  PointsFileHeader header;
+  header.flags = flags;
+  header.numPoints = numPoints;
+
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+  const uint32_t kChunkPoints = 4096;
+  float chunk[2 * kChunkPoints];
+
+  for (uint32_t i = 0; ok && i < numPoints;) {
+    const uint32_t n = (numPoints - i) < kChunkPoints ? (numPoints - i) : kChunkPoints;
+    for (uint32_t j = 0; j != n; j++) {
+      chunk[2 * j + 0] = points[i + j].x;
+      chunk[2 * j + 1] = points[i + j].y;
+    }
+    ok = fwrite(chunk, sizeof(float) * 2, n, file) == n;
+    i += n;
+  }
+
+  return fclose(file) == 0 && ok;
+}
+
+inline bool savePointsBinary(const char* fileName, const std::vector<Point>& points, uint32_t flags = 0) {
+  return savePointsBinary(fileName, points.data(), uint32_t(points.size()), flags);
+}
+
+/**
+   Zero-copy read-only view of a file written by savePointsBinary(): on POSIX the
+   payload is mmap()-ed straight from the page cache, on Windows it is read into an
+   owned buffer. dataXY() points at the packed XY pairs either way
+**/
+class PointsFileView {
+ public:
+  PointsFileView() = default;
+  PointsFileView(const PointsFileView&) = delete;
+  PointsFileView& operator=(const PointsFileView&) = delete;
+  ~PointsFileView() {
+    close();
+  }
+
+  bool open(const char* fileName) {
+    close();
+#if defined(_WIN32)
+    FILE* file = fopen(fileName, "rb");
+    if (!file)
+      return false;
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size > 0) {
+      buffer_.resize(size_t(size));
+      if (fread(buffer_.data(), 1, buffer_.size(), file) != buffer_.size())
+        buffer_.clear();
+    }
+    fclose(file);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#else
+    const int fd = ::open(fileName, O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* map = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED) {
+        map_ = map;
+        data_ = (const uint8_t*)map;
+        size_ = size_t(st.st_size);
+      }
+    }
+    ::close(fd);
+#endif
+    if (!isValid()) {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  void close() {
+#if defined(_WIN32)
+    buffer_ = std::vector<uint8_t>();
+#else
+    if (map_)
+      munmap(map_, size_);
+    map_ = nullptr;
+#endif
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  uint32_t numPoints() const {
+    return size_ ? header().numPoints : 0;
+  }
+  uint32_t flags() const {
+    return size_ ? header().flags : 0;
+  }
+  // packed XY pairs, numPoints() * 2 floats
+  const float* dataXY() const {
+    return size_ ? (const float*)(data_ + sizeof(PointsFileHeader)) : nullptr;
+  }
+  // convenience copy into the usual representation
+  std::vector<Point> toPoints() const {
+    std::vector<Point> points;
+    points.reserve(numPoints());
+    const float* xy = dataXY();
+    for (uint32_t i = 0; i != numPoints(); i++)
+      points.push_back(Point(xy[2 * i + 0], xy[2 * i + 1]));
+    return points;
+  }
+
+ private:
+  PointsFileHeader header() const {
+    PointsFileHeader h;
+    memcpy(&h, data_, sizeof(h));
+    return h;
+  }
+  bool isValid() const {
+    if (size_ < sizeof(PointsFileHeader))
+      return false;
+    const PointsFileHeader h = header();
+    return h.magic == kPointsFileMagic && h.version == kPointsFileVersion &&
+           size_ >= sizeof(PointsFileHeader) + sizeof(float) * 2 * size_t(h.numPoints);
+  }
+
+ private:
+#if defined(_WIN32)
+  std::vector<uint8_t> buffer_;
+#else
+  void* map_ = nullptr;
+#endif
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// content-address a replay token: FNV-1a over the padding-free POD bytes, so the key
+// covers the full parameter tuple and the library version
+inline uint64_t hashReplayToken(const ReplayToken& token) {
+  uint64_t hash = 14695981039346656037ull;
+  const uint8_t* bytes = (const uint8_t*)&token;
+  for (size_t i = 0; i != sizeof(token); i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+/**
+   Precomputed pattern library: point sets keyed by the full ReplayToken (parameter
+   tuple plus PoissonGenerator::Version) and stored in the binary points format under
+   one directory, so regenerating the same handful of parameter combinations across
+   thousands of assets becomes a page-cache hit. get() returns a zero-copy
+   PointsFileView over the cached file; a miss generates the pattern with the
+   deterministic parallel engine and persists it, so a cache populated on one machine
+   is valid on any other, and a library upgrade changes the keys rather than silently
+   reusing stale entries
+**/
+class PatternCache {
+ public:
+  explicit PatternCache(const char* directory, uint32_t numThreads = 0) {
+    strncpy(directory_, directory, sizeof(directory_) - 1);
+    directory_[sizeof(directory_) - 1] = 0;
+    numThreads_ = numThreads ? numThreads : std::thread::hardware_concurrency();
+    if (!numThreads_)
+      numThreads_ = 1;
+  }
+  PatternCache(const PatternCache&) = delete;
+  PatternCache& operator=(const PatternCache&) = delete;
+  ~PatternCache() {
+    for (const Entry& e : entries_)
+      delete e.view;
+  }
+
+  // the cached pattern for 'token' as a zero-copy view, or nullptr when the pattern can
+  // neither be loaded nor generated (e.g. a token from another library version); the view
+  // stays valid for the lifetime of the cache
+  template<typename PRNG = DefaultPRNG>
+  const PointsFileView* get(const ReplayToken& token) {
+    const uint64_t key = hashReplayToken(token);
+
+    for (const Entry& e : entries_)
+      if (e.key == key)
+        return e.view;
+
+    char path[sizeof(directory_) + 64];
+    snprintf(path, sizeof(path), "%s/pattern_%016llx.points", directory_, (unsigned long long)key);
+
+    PointsFileView* view = new PointsFileView();
+
+    if (!view->open(path)) {
+      // first use anywhere: generate deterministically and persist for every later bake
+      const std::vector<Point> points = replayPoissonPoints<PRNG>(token, numThreads_);
+      if (points.empty() || !savePointsBinary(path, points) || !view->open(path)) {
+        delete view;
+        return nullptr;
+      }
+    }
+
+    const Entry e = {key, view};
+    entries_.push_back(e);
+    return view;
+  }
+
+ private:
+  struct Entry {
+    uint64_t key;
+    PointsFileView* view;
+  };
+
+ private:
+  char directory_[512] = {};
+  uint32_t numThreads_ = 1;
+  std::vector<Entry> entries_;
+};
+
+// low-bias integer hash for per-instance pattern variation
+inline uint32_t hashInstanceId(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+
+/**
+   Stamp a cached unit-square pattern into world space. Per-instance variation is
+   derived from hashInstanceId(): one of the 8 symmetries of the square (the
+   square-preserving counterpart of Vogel's 'phi' rotation) plus a toroidal offset,
+   so every instance remains a valid unit-square pattern before it is scaled into
+   [worldMin..worldMax]. With patterns from generatePoissonPointsTileable() the
+   toroidal shift is seamless; for plain patterns the wrap seam carries no
+   minimum-distance guarantee. Reads and writes packed XY pairs, so the input can be
+   a PointsFileView::dataXY() span straight from the page cache
+**/
+inline void stampPattern(
+    const float* patternXY, uint32_t numPoints, uint32_t instanceId, const Point& worldMin, const Point& worldMax, float* outXY) {
+  const uint32_t h = hashInstanceId(instanceId);
+
+  const uint32_t symmetry = h & 7u;
+  const float offsX = float((h >> 3) & 0x3fffu) / 16384.0f;
+  const float offsY = float((h >> 17) & 0x3fffu) / 16384.0f;
+
+  const float scaleX = worldMax.x - worldMin.x;
+  const float scaleY = worldMax.y - worldMin.y;
+
+  for (uint32_t i = 0; i != numPoints; i++) {
+    float x = patternXY[2 * i + 0];
+    float y = patternXY[2 * i + 1];
+
+    if (symmetry & 4u)
+      x = 1.0f - x;
+
+    float rx, ry;
+    switch (symmetry & 3u) {
+      case 1:
+        rx = 1.0f - y;
+        ry = x;
+        break;
+      case 2:
+        rx = 1.0f - x;
+        ry = 1.0f - y;
+        break;
+      case 3:
+        rx = y;
+        ry = 1.0f - x;
+        break;
+      default:
+        rx = x;
+        ry = y;
+        break;
+    }
+
+    rx = wrapUnit(rx + offsX);
+    ry = wrapUnit(ry + offsY);
+
+    outXY[2 * i + 0] = worldMin.x + rx * scaleX;
+    outXY[2 * i + 1] = worldMin.y + ry * scaleY;
+  }
+}
+
+/**
+   Same, but producing the usual vector representation
+**/
+inline std::vector<Point> stampPattern(const PointsFileView& pattern, uint32_t instanceId, const Point& worldMin, const Point& worldMax) {
+  std::vector<float> xy(2 * size_t(pattern.numPoints()));
+
+  if (!xy.empty())
+    stampPattern(pattern.dataXY(), pattern.numPoints(), instanceId, worldMin, worldMax, xy.data());
+
+  std::vector<Point> points;
+  points.reserve(pattern.numPoints());
+  for (uint32_t i = 0; i != pattern.numPoints(); i++)
+    points.push_back(Point(xy[2 * i + 0], xy[2 * i + 1]));
+  return points;
 }
 
 } // namespace PoissonGenerator